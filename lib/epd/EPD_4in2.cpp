@@ -94,12 +94,88 @@ const unsigned char LUT_ALL[233]= {
 0x32,  0x30,            
 };	
 
+/******************************************************************************
+1-bpp waveforms for display mode 2, same layout as LUT_ALL. In mode 2 the
+controller picks a LUT per pixel from its (0x26, 0x24) RAM bits, i.e.
+(previous, new) with 1 = white:
+    LUT0  black -> black     LUT1  black -> white
+    LUT2  white -> black     LUT3  white -> white     LUT4  VCOM
+Each group is RP, then phases A-D as VS<<6 | TP (VS 00 = VSS, 01 = VSH1,
+10 = VSL), then the two state repeats. Levels and tail are the stock ones.
+******************************************************************************/
+#define LUT_VSS(tp)   (0x00 | (tp))
+#define LUT_VSH1(tp)  (0x40 | (tp))
+#define LUT_VSL(tp)   (0x80 | (tp))
+#define LUT_GROUP(rp, a, b, c, d)  (rp), (a), (b), (c), (d), 0x01, 0x01
+#define LUT_IDLE                   LUT_GROUP(0x00, 0x00, 0x00, 0x00, 0x00)
+#define LUT_TAIL \
+    0x00,  0x00,  0x00,  0x00,  0x00,  0x00,  0x00,  \
+    0x00,  0x00,  0x00,  0x00,  0x00,  0x00,  0x00,  \
+    0x02,  0x00,  0x00,  0x03,  0x17,  0x41,  0xA8,  \
+    0x32,  0x30
+
+// Widgets: only pixels that change are driven, one push and a short
+// settle; unchanged pixels see VSS, so nothing around the widget blinks
+static const unsigned char LUT_WIDGET[EPD_LUT_SIZE] = {
+// LUT0  B -> B
+LUT_IDLE, LUT_IDLE, LUT_IDLE, LUT_IDLE, LUT_IDLE, LUT_IDLE,
+// LUT1  B -> W
+LUT_GROUP(0x02, LUT_VSL(0x0C), LUT_VSS(0x02), 0x00, 0x00),
+LUT_IDLE, LUT_IDLE, LUT_IDLE, LUT_IDLE, LUT_IDLE,
+// LUT2  W -> B
+LUT_GROUP(0x02, LUT_VSH1(0x0C), LUT_VSS(0x02), 0x00, 0x00),
+LUT_IDLE, LUT_IDLE, LUT_IDLE, LUT_IDLE, LUT_IDLE,
+// LUT3  W -> W
+LUT_IDLE, LUT_IDLE, LUT_IDLE, LUT_IDLE, LUT_IDLE, LUT_IDLE,
+// LUT4  VCOM
+LUT_IDLE, LUT_IDLE, LUT_IDLE, LUT_IDLE, LUT_IDLE, LUT_IDLE,
+LUT_TAIL
+};
+
+// Cleaning: every pixel is shaken in both directions and parked on its
+// new colour, which clears the ghosting widget updates leave behind
+static const unsigned char LUT_CLEAN[EPD_LUT_SIZE] = {
+// LUT0  B -> B
+LUT_GROUP(0x02, LUT_VSL(0x08), LUT_VSH1(0x08), LUT_VSL(0x08), LUT_VSH1(0x08)),
+LUT_GROUP(0x01, LUT_VSH1(0x0A), LUT_VSS(0x02), 0x00, 0x00),
+LUT_IDLE, LUT_IDLE, LUT_IDLE, LUT_IDLE,
+// LUT1  B -> W
+LUT_GROUP(0x02, LUT_VSH1(0x08), LUT_VSL(0x08), LUT_VSH1(0x08), LUT_VSL(0x08)),
+LUT_GROUP(0x01, LUT_VSL(0x0A), LUT_VSS(0x02), 0x00, 0x00),
+LUT_IDLE, LUT_IDLE, LUT_IDLE, LUT_IDLE,
+// LUT2  W -> B
+LUT_GROUP(0x02, LUT_VSL(0x08), LUT_VSH1(0x08), LUT_VSL(0x08), LUT_VSH1(0x08)),
+LUT_GROUP(0x01, LUT_VSH1(0x0A), LUT_VSS(0x02), 0x00, 0x00),
+LUT_IDLE, LUT_IDLE, LUT_IDLE, LUT_IDLE,
+// LUT3  W -> W
+LUT_GROUP(0x02, LUT_VSH1(0x08), LUT_VSL(0x08), LUT_VSH1(0x08), LUT_VSL(0x08)),
+LUT_GROUP(0x01, LUT_VSL(0x0A), LUT_VSS(0x02), 0x00, 0x00),
+LUT_IDLE, LUT_IDLE, LUT_IDLE, LUT_IDLE,
+// LUT4  VCOM
+LUT_IDLE, LUT_IDLE, LUT_IDLE, LUT_IDLE, LUT_IDLE, LUT_IDLE,
+LUT_TAIL
+};
+
+// Waveform per EPD_LUT_* slot, and tuned replacements set at runtime
+static const unsigned char *const EPD_LutBuiltin[EPD_LUT_COUNT] = { NULL, LUT_ALL, LUT_WIDGET, LUT_CLEAN };
+static const unsigned char *EPD_LutTuned[EPD_LUT_COUNT];
+
+static UBYTE EPD_Mode = EPD_MODE_SLEEP;
+static UBYTE EPD_Lut = EPD_LUT_OTP;  // waveform in the LUT register right now
+static UDOUBLE EPD_LastActive = 0;   // millis() when the last update finished
+static bool EPD_Async = false;       // updates return once started, see EPD_4IN2_V2_SetAsync()
+static bool EPD_Pending = false;     // an update was started and not seen finishing yet
+static EPD_RowSource EPD_Rows = NULL; // image rows come from here, see EPD_4IN2_V2_SetRowSource()
+
 /******************************************************************************
 function :	Software reset
 parameter:
 ******************************************************************************/
 void EPD_4IN2_V2_Reset(void)
 {
+    if (EPD_Pending)
+        EPD_4IN2_V2_WaitIdle();   // a reset mid-waveform leaves the panel half driven
+    EPD_Lut = EPD_LUT_OTP;   // the LUT register does not survive a reset
     DEV_Digital_Write(EPD_RST_PIN, 1);
     DEV_Delay_ms(100);
     DEV_Digital_Write(EPD_RST_PIN, 0);
@@ -115,6 +191,8 @@ parameter:
 ******************************************************************************/
 static void EPD_4IN2_V2_SendCommand(UBYTE Reg)
 {
+    if (EPD_Pending)
+        EPD_4IN2_V2_WaitIdle();   // the controller ignores commands while BUSY
     DEV_Digital_Write(EPD_DC_PIN, 0);
     DEV_Digital_Write(EPD_CS_PIN, 0);
     DEV_SPI_WriteByte(Reg);
@@ -179,19 +257,106 @@ bool EPD_4IN2_V2_ReadBusy(void)
     Serial.println(F("[EPD] busy release"));
     Serial.flush();
 #endif
+    EPD_LastActive = millis();
     return true; // Success
 }
 
+/******************************************************************************
+function :	Wait for the update that was started last, if any
+returns  :  false if the controller timed out
+******************************************************************************/
+bool EPD_4IN2_V2_WaitIdle(void)
+{
+    if (!EPD_Pending)
+        return true;
+    EPD_Pending = false;
+    return EPD_4IN2_V2_ReadBusy();
+}
+
+/******************************************************************************
+function :	Non-blocking check for a running update. Notices completion
+            (and stamps EPD_4IN2_V2_LastDone()) as a side effect.
+******************************************************************************/
+bool EPD_4IN2_V2_Busy(void)
+{
+    if (!EPD_Pending)
+        return false;
+    if (DEV_Digital_Read(EPD_BUSY_PIN) == 1)
+        return true;
+    EPD_Pending = false;
+    EPD_LastActive = millis();
+    return false;
+}
+
+UDOUBLE EPD_4IN2_V2_LastDone(void)
+{
+    return EPD_LastActive;
+}
+
+/******************************************************************************
+function :	In async mode every Display call returns as soon as the waveform
+            is triggered; the image is already in controller RAM by then, so
+            the caller's buffer is free. The next command, reset or
+            EPD_4IN2_V2_WaitIdle() waits for BUSY to release.
+******************************************************************************/
+void EPD_4IN2_V2_SetAsync(bool On)
+{
+    if (!On)
+        EPD_4IN2_V2_WaitIdle();
+    EPD_Async = On;
+}
+
+/******************************************************************************
+function :	Where the image paths (Display, Display_Fast, PartialDisplay_Window,
+            PartialDisplay_LUT) get their rows from. NULL, the default, reads
+            EPD_4IN2_V2_WIDTH/8 bytes per row straight out of the image; a
+            source gets the image pointer as passed to the Display call and
+            returns a panel-order row for it, so a differently laid out
+            surface is converted while it is pushed instead of copied first.
+            Rows are asked for in order; `First` starts each pass.
+******************************************************************************/
+void EPD_4IN2_V2_SetRowSource(EPD_RowSource Source)
+{
+    EPD_Rows = Source;
+}
+
+static const UBYTE *EPD_4IN2_V2_Row(const UBYTE *Image, UWORD Row, bool First)
+{
+    if (EPD_Rows)
+        return EPD_Rows(Image, Row, First);
+    return Image + (UDOUBLE)Row * (EPD_4IN2_V2_WIDTH / 8);
+}
+
+// Rows Ystart..Yend-1, bytes Xs..Xe-1 of each, into the RAM selected last
+static void EPD_4IN2_V2_SendRows(const UBYTE *Image, UWORD Xs, UWORD Xe, UWORD Ystart, UWORD Yend)
+{
+    for (UWORD j = Ystart; j < Yend; j++) {
+        const UBYTE *Row = EPD_4IN2_V2_Row(Image, j, j == Ystart);
+        for (UWORD i = Xs; i < Xe; i++) {
+            EPD_4IN2_V2_SendData(Row[i]);
+        }
+    }
+}
+
+static bool EPD_4IN2_V2_Started(void)
+{
+    if (!EPD_Async)
+        return EPD_4IN2_V2_ReadBusy();
+    EPD_Pending = true;
+    return true;
+}
+
 /******************************************************************************
 function :	Turn On Display
 parameter:
 ******************************************************************************/
 static bool EPD_4IN2_V2_TurnOnDisplay(void)
 {
+    EPD_Lut = EPD_LUT_OTP;   // 0xF7 and 0xFF reload the LUT from OTP
     EPD_4IN2_V2_SendCommand(0x22);
 	EPD_4IN2_V2_SendData(0xF7);
     EPD_4IN2_V2_SendCommand(0x20);
-    return EPD_4IN2_V2_ReadBusy();
+    return EPD_4IN2_V2_Started();
 }
 
 static bool EPD_4IN2_V2_TurnOnDisplay_Fast(void)
@@ -199,15 +364,25 @@ static bool EPD_4IN2_V2_TurnOnDisplay_Fast(void)
     EPD_4IN2_V2_SendCommand(0x22);
 	EPD_4IN2_V2_SendData(0xC7);
     EPD_4IN2_V2_SendCommand(0x20);
-    return EPD_4IN2_V2_ReadBusy();
+    return EPD_4IN2_V2_Started();
 }
 
 static bool EPD_4IN2_V2_TurnOnDisplay_Partial(void)
 {
+    EPD_Lut = EPD_LUT_OTP;
     EPD_4IN2_V2_SendCommand(0x22);
 	EPD_4IN2_V2_SendData(0xFF);
     EPD_4IN2_V2_SendCommand(0x20);
-    return EPD_4IN2_V2_ReadBusy();
+    return EPD_4IN2_V2_Started();
+}
+
+// Display mode 2 with whatever LUT was uploaded (no OTP load)
+static bool EPD_4IN2_V2_TurnOnDisplay_LUT(void)
+{
+    EPD_4IN2_V2_SendCommand(0x22);
+	EPD_4IN2_V2_SendData(0xCF);
+    EPD_4IN2_V2_SendCommand(0x20);
+    return EPD_4IN2_V2_Started();
 }
 
 static bool EPD_4IN2_V2_TurnOnDisplay_4Gray(void)
@@ -215,7 +390,7 @@ static bool EPD_4IN2_V2_TurnOnDisplay_4Gray(void)
     EPD_4IN2_V2_SendCommand(0x22);
 	EPD_4IN2_V2_SendData(0xCF);
     EPD_4IN2_V2_SendCommand(0x20);
-    return EPD_4IN2_V2_ReadBusy();
+    return EPD_4IN2_V2_Started();
 }
 
 /******************************************************************************
@@ -249,34 +424,63 @@ static void EPD_4IN2_V2_SetCursor(UWORD Xstart, UWORD Ystart)
     EPD_4IN2_V2_SendData((Ystart >> 8) & 0xFF);
 }
 
-//LUT download
-static void EPD_4IN2_V2_4Gray_lut(void)
+/******************************************************************************
+function :	LUT download. The upload is skipped when the slot's waveform is
+            already in the LUT register, so alternating updates that share
+            a waveform cost no SPI traffic beyond the image.
+parameter:
+    Lut : EPD_LUT_4GRAY, EPD_LUT_WIDGET or EPD_LUT_CLEAN
+******************************************************************************/
+void EPD_4IN2_V2_LoadLUT(UBYTE Lut)
 {
+    if (Lut == EPD_LUT_OTP || Lut >= EPD_LUT_COUNT || Lut == EPD_Lut)
+        return;
+    const unsigned char *Table = EPD_LutTuned[Lut] ? EPD_LutTuned[Lut] : EPD_LutBuiltin[Lut];
     unsigned char i;
 
-    //WS byte 0~152, the content of VS[nX-LUTm], TP[nX], RP[n], SR[nXY], FR[n] and XON[nXY]
+    //WS byte 0~226, the content of VS[nX-LUTm], TP[nX], RP[n], SR[nXY], FR[n] and XON[nXY]
     EPD_4IN2_V2_SendCommand(0x32);					
     for(i=0;i<227;i++)
     {
-        EPD_4IN2_V2_SendData(LUT_ALL[i]);
+        EPD_4IN2_V2_SendData(Table[i]);
     }	
-    //WS byte 153, the content of Option for LUT end	
+    //WS byte 227, the content of Option for LUT end	
     EPD_4IN2_V2_SendCommand(0x3F);					
-    EPD_4IN2_V2_SendData(LUT_ALL[i++]);
+    EPD_4IN2_V2_SendData(Table[i++]);
 
-    //WS byte 154, the content of gate leve
+    //WS byte 228, the content of gate leve
     EPD_4IN2_V2_SendCommand(0x03);					
-    EPD_4IN2_V2_SendData(LUT_ALL[i++]);//VGH
+    EPD_4IN2_V2_SendData(Table[i++]);//VGH
 
-    //WS byte 155~157, the content of source level
+    //WS byte 229~231, the content of source level
     EPD_4IN2_V2_SendCommand(0x04);					
-    EPD_4IN2_V2_SendData(LUT_ALL[i++]);//VSH1
-    EPD_4IN2_V2_SendData(LUT_ALL[i++]);//VSH2
-    EPD_4IN2_V2_SendData(LUT_ALL[i++]);//VSL
+    EPD_4IN2_V2_SendData(Table[i++]);//VSH1
+    EPD_4IN2_V2_SendData(Table[i++]);//VSH2
+    EPD_4IN2_V2_SendData(Table[i++]);//VSL
 
-    //WS byte 158, the content of VCOM level
+    //WS byte 232, the content of VCOM level
     EPD_4IN2_V2_SendCommand(0x2c);					
-    EPD_4IN2_V2_SendData(LUT_ALL[i++]);//VCOM
+    EPD_4IN2_V2_SendData(Table[i++]);//VCOM
+    EPD_Lut = Lut;
+}
+
+/******************************************************************************
+function :	Replace a slot's waveform, e.g. with one tuned for this batch of
+            panels. The table (EPD_LUT_SIZE bytes) must stay valid; NULL
+            restores the built-in one.
+******************************************************************************/
+void EPD_4IN2_V2_SetLUT(UBYTE Lut, const UBYTE *Table)
+{
+    if (Lut == EPD_LUT_OTP || Lut >= EPD_LUT_COUNT)
+        return;
+    EPD_LutTuned[Lut] = Table;
+    if (EPD_Lut == Lut)
+        EPD_Lut = EPD_LUT_OTP;   // force a fresh upload on next use
+}
+
+UBYTE EPD_4IN2_V2_GetLUT(void)
+{
+    return EPD_Lut;
 }
 
 /******************************************************************************
@@ -311,6 +515,7 @@ void EPD_4IN2_V2_Init(void)
 	EPD_4IN2_V2_SetCursor(0, 0);
 	
     EPD_4IN2_V2_ReadBusy();
+    EPD_Mode = EPD_MODE_FULL;
 }
 
 /******************************************************************************
@@ -358,6 +563,7 @@ void EPD_4IN2_V2_Init_Fast(UBYTE Mode)
 	EPD_4IN2_V2_SetCursor(0, 0);
 	
     EPD_4IN2_V2_ReadBusy();
+    EPD_Mode = (Mode == Seconds_1S) ? EPD_MODE_FAST_1S : EPD_MODE_FAST_1_5S;
 }
 
 
@@ -386,7 +592,7 @@ void EPD_4IN2_V2_Init_4Gray(void)
     // EPD_4IN2_V2_SendData(0x01); //  Y 的高字节 
     // EPD_4IN2_V2_SendData(0x00);
 
-    EPD_4IN2_V2_4Gray_lut(); //LUT
+    EPD_4IN2_V2_LoadLUT(EPD_LUT_4GRAY); //LUT
 
     EPD_4IN2_V2_SendCommand(0x11);	// data  entry  mode
     EPD_4IN2_V2_SendData(0x03);		// X-mode   
@@ -394,6 +600,7 @@ void EPD_4IN2_V2_Init_4Gray(void)
 	EPD_4IN2_V2_SetWindows(0, 0, EPD_4IN2_V2_WIDTH-1, EPD_4IN2_V2_HEIGHT-1);
 	 
 	EPD_4IN2_V2_SetCursor(0, 0);
+    EPD_Mode = EPD_MODE_4GRAY;
 }
 /******************************************************************************
 function :	Clear screen
@@ -432,18 +639,10 @@ bool EPD_4IN2_V2_Display(UBYTE *Image)
     Height = EPD_4IN2_V2_HEIGHT;
 
     EPD_4IN2_V2_SendCommand(0x24);
-    for (UWORD j = 0; j < Height; j++) {
-        for (UWORD i = 0; i < Width; i++) {
-            EPD_4IN2_V2_SendData(Image[i + j * Width]);
-        }
-    }
+    EPD_4IN2_V2_SendRows(Image, 0, Width, 0, Height);
 
     EPD_4IN2_V2_SendCommand(0x26);
-    for (UWORD j = 0; j < Height; j++) {
-        for (UWORD i = 0; i < Width; i++) {
-            EPD_4IN2_V2_SendData(Image[i + j * Width]);
-        }
-    }
+    EPD_4IN2_V2_SendRows(Image, 0, Width, 0, Height);
     return EPD_4IN2_V2_TurnOnDisplay();
 }
 
@@ -458,18 +657,10 @@ bool EPD_4IN2_V2_Display_Fast(UBYTE *Image)
     Height = EPD_4IN2_V2_HEIGHT;
 
     EPD_4IN2_V2_SendCommand(0x24);
-    for (UWORD j = 0; j < Height; j++) {
-        for (UWORD i = 0; i < Width; i++) {
-            EPD_4IN2_V2_SendData(Image[i + j * Width]);
-        }
-    }
+    EPD_4IN2_V2_SendRows(Image, 0, Width, 0, Height);
 
     EPD_4IN2_V2_SendCommand(0x26);
-    for (UWORD j = 0; j < Height; j++) {
-        for (UWORD i = 0; i < Width; i++) {
-            EPD_4IN2_V2_SendData(Image[i + j * Width]);
-        }
-    }
+    EPD_4IN2_V2_SendRows(Image, 0, Width, 0, Height);
     return EPD_4IN2_V2_TurnOnDisplay_Fast();
 }
 
@@ -605,6 +796,7 @@ bool EPD_4IN2_V2_PartialDisplay(UBYTE *Image, UWORD Xstart, UWORD Ystart, UWORD
 
 	EPD_4IN2_V2_SendCommand(0x3C); 
 	EPD_4IN2_V2_SendData(0x80); 
+	EPD_Mode = EPD_MODE_PARTIAL;
 
     EPD_4IN2_V2_SendCommand(0x11);	// data  entry  mode
     EPD_4IN2_V2_SendData(0x03);		// X-mode  
@@ -633,6 +825,98 @@ bool EPD_4IN2_V2_PartialDisplay(UBYTE *Image, UWORD Xstart, UWORD Ystart, UWORD
 
 	return EPD_4IN2_V2_TurnOnDisplay_Partial();
 }
+/******************************************************************************
+function :	Partial refresh of a window, read straight out of a full-panel
+            framebuffer (no copy of the window into a separate buffer)
+parameter:
+    Frame  : full 400x300 image, EPD_4IN2_V2_WIDTH/8 bytes per row
+             (or any layout the row source understands)
+    Xstart : left edge in pixels, multiple of 8
+    Xend   : right edge in pixels (exclusive), multiple of 8
+    Ystart : top row
+    Yend   : bottom row (exclusive)
+******************************************************************************/
+bool EPD_4IN2_V2_PartialDisplay_Window(const UBYTE *Frame, UWORD Xstart, UWORD Ystart, UWORD Xend, UWORD Yend)
+{
+    UWORD Xs = Xstart / 8, Xe = Xend / 8;
+    if (Xe <= Xs || Yend <= Ystart)
+        return true;
+
+    if (EPD_Mode == EPD_MODE_SLEEP)
+        EPD_4IN2_V2_Init_Fast(Seconds_1_5S);
+
+	EPD_4IN2_V2_SendCommand(0x21); 
+	EPD_4IN2_V2_SendData(0x00);
+	EPD_4IN2_V2_SendData(0x00);
+
+	EPD_4IN2_V2_SendCommand(0x3C); 
+	EPD_4IN2_V2_SendData(0x80); 
+	EPD_Mode = EPD_MODE_PARTIAL;
+
+    EPD_4IN2_V2_SendCommand(0x11);	// data  entry  mode
+    EPD_4IN2_V2_SendData(0x03);		// X-mode  
+
+    EPD_4IN2_V2_SetWindows(Xstart, Ystart, Xend - 1, Yend - 1);
+    EPD_4IN2_V2_SetCursor(Xstart, Ystart);
+    EPD_4IN2_V2_ReadBusy();
+
+    EPD_4IN2_V2_SendCommand(0x24);
+    EPD_4IN2_V2_SendRows(Frame, Xs, Xe, Ystart, Yend);
+	return EPD_4IN2_V2_TurnOnDisplay_Partial();
+}
+
+/******************************************************************************
+function :	Partial refresh of a window with an uploaded 1-bpp waveform
+            (EPD_LUT_WIDGET or EPD_LUT_CLEAN) instead of the OTP one.
+            Switching between the two, or repeating either, needs no
+            re-init: only the LUT register changes, and only when the
+            waveform differs from the resident one. Same framebuffer and
+            window rules as EPD_4IN2_V2_PartialDisplay_Window().
+            The window is written to 0x26 afterwards as well, so the next
+            update compares against what is now on the glass; that write
+            waits for the waveform, so this call blocks even in async mode.
+            Without EPD_UPLOADED_LUTS this is PartialDisplay_Window().
+******************************************************************************/
+bool EPD_4IN2_V2_PartialDisplay_LUT(const UBYTE *Frame, UWORD Xstart, UWORD Ystart, UWORD Xend, UWORD Yend, UBYTE Lut)
+{
+#if !EPD_UPLOADED_LUTS
+    (void)Lut;
+    return EPD_4IN2_V2_PartialDisplay_Window(Frame, Xstart, Ystart, Xend, Yend);
+#else
+    UWORD Xs = Xstart / 8, Xe = Xend / 8;
+    if (Xe <= Xs || Yend <= Ystart)
+        return true;
+
+    if (EPD_Mode == EPD_MODE_SLEEP)
+        EPD_4IN2_V2_Init_Fast(Seconds_1_5S);
+
+    if (EPD_Mode != EPD_MODE_LUT) {
+        EPD_4IN2_V2_SendCommand(0x21);   // both RAMs as written: mode 2 needs the old image
+        EPD_4IN2_V2_SendData(0x00);
+        EPD_4IN2_V2_SendData(0x00);
+
+        EPD_4IN2_V2_SendCommand(0x3C);   // border follows VSS, never flashes
+        EPD_4IN2_V2_SendData(0x80);
+
+        EPD_4IN2_V2_SendCommand(0x11);	// data  entry  mode
+        EPD_4IN2_V2_SendData(0x03);		// X-mode
+        EPD_Mode = EPD_MODE_LUT;
+    }
+    EPD_4IN2_V2_LoadLUT(Lut);
+
+    EPD_4IN2_V2_SetWindows(Xstart, Ystart, Xend - 1, Yend - 1);
+    EPD_4IN2_V2_SetCursor(Xstart, Ystart);
+    EPD_4IN2_V2_SendCommand(0x24);
+    EPD_4IN2_V2_SendRows(Frame, Xs, Xe, Ystart, Yend);
+    bool ok = EPD_4IN2_V2_TurnOnDisplay_LUT();
+
+    EPD_4IN2_V2_SetCursor(Xstart, Ystart);
+    EPD_4IN2_V2_SendCommand(0x26);
+    EPD_4IN2_V2_SendRows(Frame, Xs, Xe, Ystart, Yend);
+    return ok;
+#endif
+}
+
 /******************************************************************************
 function :	Enter sleep mode
 parameter:
@@ -642,4 +926,62 @@ void EPD_4IN2_V2_Sleep(void)
     EPD_4IN2_V2_SendCommand(0x10); // DEEP_SLEEP
     EPD_4IN2_V2_SendData(0x01);
 	DEV_Delay_ms(200);
+    EPD_Mode = EPD_MODE_SLEEP;
+}
+
+/******************************************************************************
+function :	Bring the controller into the given mode, waking it if needed.
+            Registers are only reprogrammed when the mode actually changes,
+            so back-to-back refreshes in the same mode cost nothing extra.
+parameter:
+    Mode : EPD_MODE_FULL, EPD_MODE_FAST_1_5S, EPD_MODE_FAST_1S or EPD_MODE_4GRAY
+******************************************************************************/
+void EPD_4IN2_V2_Ensure(UBYTE Mode)
+{
+    if (EPD_Mode == Mode)
+        return;
+
+    // Every init path starts with a hardware reset, which is also what
+    // takes the controller out of deep sleep.
+    switch (Mode) {
+    case EPD_MODE_FULL:
+        EPD_4IN2_V2_Init();
+        break;
+    case EPD_MODE_FAST_1_5S:
+        EPD_4IN2_V2_Init_Fast(Seconds_1_5S);
+        break;
+    case EPD_MODE_FAST_1S:
+        EPD_4IN2_V2_Init_Fast(Seconds_1S);
+        break;
+    case EPD_MODE_4GRAY:
+        EPD_4IN2_V2_Init_4Gray();
+        break;
+    default:
+        break;
+    }
+}
+
+UBYTE EPD_4IN2_V2_GetMode(void)
+{
+    return EPD_Mode;
+}
+
+/******************************************************************************
+function :	Put the controller into deep sleep once it has been idle long
+            enough. The hold-off keeps the ~200ms reset + init wake cost out
+            of interactive navigation, where refreshes come seconds apart.
+parameter:
+    Idle_ms : time since the last completed update before sleeping
+returns  :  true if the controller was put to sleep by this call
+******************************************************************************/
+bool EPD_4IN2_V2_SleepIfIdle(UDOUBLE Idle_ms)
+{
+    if (EPD_Mode == EPD_MODE_SLEEP || EPD_4IN2_V2_Busy())
+        return false;
+    if (millis() - EPD_LastActive < Idle_ms)
+        return false;
+    if (DEV_Digital_Read(EPD_BUSY_PIN) == 1)
+        return false;
+    EPD_4IN2_V2_Sleep();
+    return true;
 }
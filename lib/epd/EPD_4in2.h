@@ -11,6 +11,33 @@
 #define Seconds_1_5S      0
 #define Seconds_1S        1
 
+// Controller register state, tracked so callers only re-init on mode changes
+#define EPD_MODE_SLEEP      0   // deep sleep (or never initialised)
+#define EPD_MODE_FULL       1
+#define EPD_MODE_FAST_1_5S  2
+#define EPD_MODE_FAST_1S    3
+#define EPD_MODE_4GRAY      4
+#define EPD_MODE_PARTIAL    5
+#define EPD_MODE_LUT        6   // mode 2 with an uploaded 1-bpp waveform
+
+// Waveform slots for the LUT register (see EPD_4IN2_V2_LoadLUT)
+#define EPD_LUT_OTP         0   // controller's own, loaded by the init paths
+#define EPD_LUT_4GRAY       1
+#define EPD_LUT_WIDGET      2   // minimal flicker, changed pixels only
+#define EPD_LUT_CLEAN       3   // drives every pixel, clears ghosting
+#define EPD_LUT_COUNT       4
+#define EPD_LUT_SIZE        233
+
+// The widget and cleaning tables have not been confirmed on a real panel
+// yet. Until a build sets EPD_UPLOADED_LUTS=1, EPD_4IN2_V2_PartialDisplay_LUT
+// refreshes with the OTP partial waveform (0xFF) instead.
+#ifndef EPD_UPLOADED_LUTS
+#define EPD_UPLOADED_LUTS   0
+#endif
+
+// Supplies image rows in panel order, see EPD_4IN2_V2_SetRowSource()
+typedef const UBYTE *(*EPD_RowSource)(const UBYTE *Image, UWORD Row, bool First);
+
 void EPD_4IN2_V2_Init(void);
 void EPD_4IN2_V2_Init_Fast(UBYTE Mode);
 void EPD_4IN2_V2_Init_4Gray(void);
@@ -20,8 +47,21 @@ bool EPD_4IN2_V2_Display_Fast(UBYTE *Image);
 bool EPD_4IN2_V2_Display_4Gray(const UBYTE *Image);
 bool EPD_4IN2_V2_PartialDisplay(UBYTE *Image, UWORD Xstart, UWORD Ystart, UWORD Xend, UWORD Yend);
 bool EPD_4IN2_V2_PartialDisplay(UBYTE *Image);
+bool EPD_4IN2_V2_PartialDisplay_Window(const UBYTE *Frame, UWORD Xstart, UWORD Ystart, UWORD Xend, UWORD Yend);
+bool EPD_4IN2_V2_PartialDisplay_LUT(const UBYTE *Frame, UWORD Xstart, UWORD Ystart, UWORD Xend, UWORD Yend, UBYTE Lut);
+void EPD_4IN2_V2_LoadLUT(UBYTE Lut);
+void EPD_4IN2_V2_SetLUT(UBYTE Lut, const UBYTE *Table);
+UBYTE EPD_4IN2_V2_GetLUT(void);
 void EPD_4IN2_V2_Sleep(void);
+void EPD_4IN2_V2_Ensure(UBYTE Mode);
+UBYTE EPD_4IN2_V2_GetMode(void);
+bool EPD_4IN2_V2_SleepIfIdle(UDOUBLE Idle_ms);
 bool EPD_4IN2_V2_ReadBusy(void);
+void EPD_4IN2_V2_SetAsync(bool On);
+void EPD_4IN2_V2_SetRowSource(EPD_RowSource Source);
+bool EPD_4IN2_V2_Busy(void);
+bool EPD_4IN2_V2_WaitIdle(void);
+UDOUBLE EPD_4IN2_V2_LastDone(void);
 void EPD_4IN2_V2_Reset(void);
 
 #endif
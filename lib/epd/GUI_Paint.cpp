@@ -118,6 +118,7 @@ void Paint_NewImage(UBYTE *image, UWORD Width, UWORD Height, UWORD Rotate, UWORD
         Paint.Width = Height;
         Paint.Height = Width;
     }
+    Paint_ResetClip();
 }
 
 /******************************************************************************
@@ -182,18 +183,14 @@ void Paint_SetScale(UBYTE scale)
     }
 }
 /******************************************************************************
-function: Draw Pixels
+function: Write one pixel, no clipping (callers clip whole spans first)
 parameter:
     Xpoint : At point X
     Ypoint : At point Y
     Color  : Painted colors
 ******************************************************************************/
-void Paint_SetPixel(UWORD Xpoint, UWORD Ypoint, UWORD Color)
+static void Paint_PutPixel(UWORD Xpoint, UWORD Ypoint, UWORD Color)
 {
-    if(Xpoint > Paint.Width || Ypoint > Paint.Height){
-        Debug("Exceeding display boundaries\r\n");
-        return;
-    }      
     UWORD X, Y;
     switch(Paint.Rotate) {
     case 0:
@@ -261,6 +258,152 @@ void Paint_SetPixel(UWORD Xpoint, UWORD Ypoint, UWORD Color)
     }
 }
 
+/******************************************************************************
+function: Draw Pixels
+parameter:
+    Xpoint : At point X
+    Ypoint : At point Y
+    Color  : Painted colors
+******************************************************************************/
+void Paint_SetPixel(UWORD Xpoint, UWORD Ypoint, UWORD Color)
+{
+    if (Xpoint < Paint.ClipX0 || Xpoint >= Paint.ClipX1 ||
+        Ypoint < Paint.ClipY0 || Ypoint >= Paint.ClipY1)
+        return;
+    Paint_PutPixel(Xpoint, Ypoint, Color);
+}
+
+/******************************************************************************
+function: Fill a horizontal run of pixels, clipped once for the whole run
+parameter:
+    Xstart : x starting point
+    Xend   : x end point (inclusive)
+    Ypoint : row
+    Color  : Painted colors
+info:
+    Unrotated, unmirrored 1bpp images get byte masks and memset; anything
+    else writes the surviving pixels one by one.
+******************************************************************************/
+static void Paint_FillSpan(int Xstart, int Xend, int Ypoint, UWORD Color)
+{
+    if (Ypoint < Paint.ClipY0 || Ypoint >= Paint.ClipY1)
+        return;
+    if (Xstart < Paint.ClipX0)
+        Xstart = Paint.ClipX0;
+    if (Xend >= Paint.ClipX1)
+        Xend = Paint.ClipX1 - 1;
+    if (Xstart > Xend)
+        return;
+
+    if (Paint.Rotate != ROTATE_0 || Paint.Mirror != MIRROR_NONE || Paint.Scale != 2) {
+        for (int X = Xstart; X <= Xend; X++)
+            Paint_PutPixel(X, Ypoint, Color);
+        return;
+    }
+
+    UBYTE *Row = Paint.Image + (UDOUBLE)Ypoint * Paint.WidthByte;
+    int First = Xstart / 8, Last = Xend / 8;
+    UBYTE Head = 0xFF >> (Xstart % 8), Tail = 0xFF << (7 - Xend % 8);
+    if (First == Last)
+        Head &= Tail;
+    if (Color == BLACK) {
+        Row[First] &= ~Head;
+        if (First != Last) {
+            memset(Row + First + 1, 0x00, Last - First - 1);
+            Row[Last] &= ~Tail;
+        }
+    } else {
+        Row[First] |= Head;
+        if (First != Last) {
+            memset(Row + First + 1, 0xFF, Last - First - 1);
+            Row[Last] |= Tail;
+        }
+    }
+}
+
+/******************************************************************************
+function: Fill a rectangle (inclusive corners) as clipped spans
+******************************************************************************/
+static void Paint_FillRect(int Xstart, int Ystart, int Xend, int Yend, UWORD Color)
+{
+    if (Ystart < Paint.ClipY0)
+        Ystart = Paint.ClipY0;
+    if (Yend >= Paint.ClipY1)
+        Yend = Paint.ClipY1 - 1;
+    for (int Y = Ystart; Y <= Yend; Y++)
+        Paint_FillSpan(Xstart, Xend, Y, Color);
+}
+
+/******************************************************************************
+function: Clip stack
+parameter:
+    Xstart : x starting point
+    Ystart : Y starting point
+    Xend   : x end point (exclusive)
+    Yend   : y end point (exclusive)
+info:
+    A pushed rectangle is intersected with the one below it, so a nested
+    widget can never widen its parent's window. Past PAINT_CLIP_DEPTH the
+    push clips everything until the matching pop and returns 0.
+******************************************************************************/
+typedef struct {
+    UWORD X0, Y0, X1, Y1;
+} PAINT_CLIP;
+
+static PAINT_CLIP Clip_Stack[PAINT_CLIP_DEPTH + 1];
+
+UBYTE Paint_PushClip(UWORD Xstart, UWORD Ystart, UWORD Xend, UWORD Yend)
+{
+    UBYTE Fits = Paint.ClipDepth < PAINT_CLIP_DEPTH;
+    if (Paint.ClipDepth <= PAINT_CLIP_DEPTH) {
+        PAINT_CLIP *Saved = &Clip_Stack[Paint.ClipDepth];
+        Saved->X0 = Paint.ClipX0;
+        Saved->Y0 = Paint.ClipY0;
+        Saved->X1 = Paint.ClipX1;
+        Saved->Y1 = Paint.ClipY1;
+    }
+    if (Paint.ClipDepth < 0xFF)
+        Paint.ClipDepth++;
+
+    if (!Fits) {
+        Debug("Paint_PushClip: clip stack full\r\n");
+        Xstart = Xend = Ystart = Yend = 0;
+    }
+    if (Xstart > Paint.ClipX0) Paint.ClipX0 = Xstart;
+    if (Ystart > Paint.ClipY0) Paint.ClipY0 = Ystart;
+    if (Xend < Paint.ClipX1) Paint.ClipX1 = Xend;
+    if (Yend < Paint.ClipY1) Paint.ClipY1 = Yend;
+    // Empty windows stay well-formed: nothing passes X0 <= x < X1
+    if (Paint.ClipX1 < Paint.ClipX0) Paint.ClipX1 = Paint.ClipX0;
+    if (Paint.ClipY1 < Paint.ClipY0) Paint.ClipY1 = Paint.ClipY0;
+    return Fits;
+}
+
+void Paint_PopClip(void)
+{
+    if (Paint.ClipDepth == 0) {
+        Debug("Paint_PopClip: clip stack empty\r\n");
+        return;
+    }
+    Paint.ClipDepth--;
+    if (Paint.ClipDepth > PAINT_CLIP_DEPTH)
+        return;   // still inside an overflowed push
+    const PAINT_CLIP *Saved = &Clip_Stack[Paint.ClipDepth];
+    Paint.ClipX0 = Saved->X0;
+    Paint.ClipY0 = Saved->Y0;
+    Paint.ClipX1 = Saved->X1;
+    Paint.ClipY1 = Saved->Y1;
+}
+
+void Paint_ResetClip(void)
+{
+    Paint.ClipDepth = 0;
+    Paint.ClipX0 = 0;
+    Paint.ClipY0 = 0;
+    Paint.ClipX1 = Paint.Width;
+    Paint.ClipY1 = Paint.Height;
+}
+
 /******************************************************************************
 function: Clear the color of the picture
 parameter:
@@ -268,6 +411,13 @@ parameter:
 ******************************************************************************/
 void Paint_Clear(UWORD Color)
 {
+    // Inside a clip only the window is cleared
+    if (Paint.ClipX0 != 0 || Paint.ClipY0 != 0 ||
+        Paint.ClipX1 != Paint.Width || Paint.ClipY1 != Paint.Height) {
+        Paint_ClearWindows(Paint.ClipX0, Paint.ClipY0, Paint.ClipX1, Paint.ClipY1, Color);
+        return;
+    }
+
     if(Paint.Scale == 2) {
 		for (UWORD Y = 0; Y < Paint.HeightByte; Y++) {
 			for (UWORD X = 0; X < Paint.WidthByte; X++ ) {//8 pixel =  1 byte
@@ -303,12 +453,16 @@ parameter:
 ******************************************************************************/
 void Paint_ClearWindows(UWORD Xstart, UWORD Ystart, UWORD Xend, UWORD Yend, UWORD Color)
 {
-    UWORD X, Y;
-    for (Y = Ystart; Y < Yend; Y++) {
-        for (X = Xstart; X < Xend; X++) {//8 pixel =  1 byte
-            Paint_SetPixel(X, Y, Color);
+    if (Paint.Scale != 2) {
+        UWORD X, Y;
+        for (Y = Ystart; Y < Yend; Y++) {
+            for (X = Xstart; X < Xend; X++) {
+                Paint_SetPixel(X, Y, Color);
+            }
         }
+        return;
     }
+    Paint_FillRect(Xstart, Ystart, (int)Xend - 1, (int)Yend - 1, Color);
 }
 
 /******************************************************************************
@@ -328,22 +482,13 @@ void Paint_DrawPoint(UWORD Xpoint, UWORD Ypoint, UWORD Color,
         return;
     }
 
-    int16_t XDir_Num , YDir_Num;
+    // The dot is a square of spans; the clip trims it, including at x/y < 0
     if (Dot_Style == DOT_FILL_AROUND) {
-        for (XDir_Num = 0; XDir_Num < 2 * Dot_Pixel - 1; XDir_Num++) {
-            for (YDir_Num = 0; YDir_Num < 2 * Dot_Pixel - 1; YDir_Num++) {
-                if(Xpoint + XDir_Num - Dot_Pixel < 0 || Ypoint + YDir_Num - Dot_Pixel < 0)
-                    break;
-                // printf("x = %d, y = %d\r\n", Xpoint + XDir_Num - Dot_Pixel, Ypoint + YDir_Num - Dot_Pixel);
-                Paint_SetPixel(Xpoint + XDir_Num - Dot_Pixel, Ypoint + YDir_Num - Dot_Pixel, Color);
-            }
-        }
+        Paint_FillRect(Xpoint - Dot_Pixel, Ypoint - Dot_Pixel,
+                       Xpoint + Dot_Pixel - 2, Ypoint + Dot_Pixel - 2, Color);
     } else {
-        for (XDir_Num = 0; XDir_Num <  Dot_Pixel; XDir_Num++) {
-            for (YDir_Num = 0; YDir_Num <  Dot_Pixel; YDir_Num++) {
-                Paint_SetPixel(Xpoint + XDir_Num - 1, Ypoint + YDir_Num - 1, Color);
-            }
-        }
+        Paint_FillRect(Xpoint - 1, Ypoint - 1,
+                       Xpoint + Dot_Pixel - 2, Ypoint + Dot_Pixel - 2, Color);
     }
 }
 
@@ -367,6 +512,20 @@ void Paint_DrawLine(UWORD Xstart, UWORD Ystart, UWORD Xend, UWORD Yend,
         return;
     }
 
+    // Pen squares reach Line_width above/left of the path, Line_width - 2 below/right
+    int Xmin = Xstart < Xend ? Xstart : Xend, Xmax = Xstart < Xend ? Xend : Xstart;
+    int Ymin = Ystart < Yend ? Ystart : Yend, Ymax = Ystart < Yend ? Yend : Ystart;
+    if (Xmax + Line_width - 2 < Paint.ClipX0 || Xmin - Line_width >= Paint.ClipX1 ||
+        Ymax + Line_width - 2 < Paint.ClipY0 || Ymin - Line_width >= Paint.ClipY1)
+        return;
+
+    // Solid horizontal and vertical lines are one clipped rectangle
+    if (Line_Style == LINE_STYLE_SOLID && (Xstart == Xend || Ystart == Yend)) {
+        Paint_FillRect(Xmin - Line_width, Ymin - Line_width,
+                       Xmax + Line_width - 2, Ymax + Line_width - 2, Color);
+        return;
+    }
+
     UWORD Xpoint = Xstart;
     UWORD Ypoint = Ystart;
     int dx = (int)Xend - (int)Xstart >= 0 ? Xend - Xstart : Xstart - Xend;
@@ -426,9 +585,11 @@ void Paint_DrawRectangle(UWORD Xstart, UWORD Ystart, UWORD Xend, UWORD Yend,
     }
 
     if (Draw_Fill) {
-        UWORD Ypoint;
-        for(Ypoint = Ystart; Ypoint < Yend; Ypoint++) {
-            Paint_DrawLine(Xstart, Ypoint, Xend, Ypoint, Color , Line_width, LINE_STYLE_SOLID);
+        // Rows Ystart..Yend-1 of Xstart..Xend, each widened by the pen
+        if (Ystart < Yend) {
+            int Xmin = Xstart < Xend ? Xstart : Xend, Xmax = Xstart < Xend ? Xend : Xstart;
+            Paint_FillRect(Xmin - Line_width, Ystart - Line_width,
+                           Xmax + Line_width - 2, Yend - 1 + Line_width - 2, Color);
         }
     } else {
         Paint_DrawLine(Xstart, Ystart, Xend, Ystart, Color, Line_width, LINE_STYLE_SOLID);
@@ -457,6 +618,12 @@ void Paint_DrawCircle(UWORD X_Center, UWORD Y_Center, UWORD Radius,
         return;
     }
 
+    // Whole circle outside the clip: skip the walk; points clip themselves
+    int Reach = Radius + Line_width;
+    if (X_Center + Reach < Paint.ClipX0 || X_Center - Reach >= Paint.ClipX1 ||
+        Y_Center + Reach < Paint.ClipY0 || Y_Center - Reach >= Paint.ClipY1)
+        return;
+
     //Draw a circle from(0, R) as a starting point
     int16_t XCurrent, YCurrent;
     XCurrent = 0;
@@ -528,32 +695,29 @@ void Paint_DrawChar(UWORD Xpoint, UWORD Ypoint, const char Acsii_Char,
         return;
     }
 
-    uint32_t Char_Offset = (Acsii_Char - ' ') * Font->Height * (Font->Width / 8 + (Font->Width % 8 ? 1 : 0));
+    UWORD Stride = Font->Width / 8 + (Font->Width % 8 ? 1 : 0);
+    uint32_t Char_Offset = (Acsii_Char - ' ') * Font->Height * Stride;
     const unsigned char *ptr = &Font->table[Char_Offset];
 
-    for (Page = 0; Page < Font->Height; Page ++ ) {
-        for (Column = 0; Column < Font->Width; Column ++ ) {
+    // Clip the glyph box once; the loops below only visit visible pixels
+    int Page_Start = Paint.ClipY0 > Ypoint ? Paint.ClipY0 - Ypoint : 0;
+    int Page_End = Paint.ClipY1 - Ypoint < Font->Height ? Paint.ClipY1 - Ypoint : Font->Height;
+    int Column_Start = Paint.ClipX0 > Xpoint ? Paint.ClipX0 - Xpoint : 0;
+    int Column_End = Paint.ClipX1 - Xpoint < Font->Width ? Paint.ClipX1 - Xpoint : Font->Width;
+
+    for (Page = Page_Start; (int)Page < Page_End; Page ++ ) {
+        const unsigned char *Row = ptr + Page * Stride;
+        for (Column = Column_Start; (int)Column < Column_End; Column ++ ) {
+            UBYTE Ink = Row[Column / 8] & (0x80 >> (Column % 8));
 
             //To determine whether the font background color and screen background color is consistent
             if (FONT_BACKGROUND == Color_Background) { //this process is to speed up the scan
-                if (*ptr & (0x80 >> (Column % 8)))
-                    Paint_SetPixel(Xpoint + Column, Ypoint + Page, Color_Foreground);
-                    // Paint_DrawPoint(Xpoint + Column, Ypoint + Page, Color_Foreground, DOT_PIXEL_DFT, DOT_STYLE_DFT);
+                if (Ink)
+                    Paint_PutPixel(Xpoint + Column, Ypoint + Page, Color_Foreground);
             } else {
-                if (*ptr & (0x80 >> (Column % 8))) {
-                    Paint_SetPixel(Xpoint + Column, Ypoint + Page, Color_Foreground);
-                    // Paint_DrawPoint(Xpoint + Column, Ypoint + Page, Color_Foreground, DOT_PIXEL_DFT, DOT_STYLE_DFT);
-                } else {
-                    Paint_SetPixel(Xpoint + Column, Ypoint + Page, Color_Background);
-                    // Paint_DrawPoint(Xpoint + Column, Ypoint + Page, Color_Background, DOT_PIXEL_DFT, DOT_STYLE_DFT);
-                }
+                Paint_PutPixel(Xpoint + Column, Ypoint + Page, Ink ? Color_Foreground : Color_Background);
             }
-            //One pixel is 8 bits
-            if (Column % 8 == 7)
-                ptr++;
         }// Write a line
-        if (Font->Width % 8 != 0)
-            ptr++;
     }// Write all
 }
 
@@ -578,18 +742,8 @@ void Paint_DrawString_EN(UWORD Xstart, UWORD Ystart, const char * pString,
         return;
     }
 
-    while (* pString != '\0') {
-        //if X direction filled , reposition to(Xstart,Ypoint),Ypoint is Y direction plus the Height of the character
-        if ((Xpoint + Font->Width ) > Paint.Width ) {
-            Xpoint = Xstart;
-            Ypoint += Font->Height;
-        }
-
-        // If the Y direction is full, reposition to(Xstart, Ystart)
-        if ((Ypoint  + Font->Height ) > Paint.Height ) {
-            Xpoint = Xstart;
-            Ypoint = Ystart;
-        }
+    // One line, cut at the clip edge: no wrapping back over earlier text
+    while (* pString != '\0' && Xpoint < Paint.ClipX1) {
         Paint_DrawChar(Xpoint, Ypoint, * pString, Font, Color_Background, Color_Foreground);
 
         //The next character of the address
@@ -610,36 +764,30 @@ parameter:
     Color_Foreground : Select the foreground color
     Color_Background : Select the background color
 ******************************************************************************/
-#define  ARRAY_LEN 255
 void Paint_DrawNum(UWORD Xpoint, UWORD Ypoint, int32_t Nummber,
                    sFONT* Font, UWORD Color_Foreground, UWORD Color_Background)
 {
-
-    int16_t Num_Bit = 0, Str_Bit = 0;
-    uint8_t Str_Array[ARRAY_LEN] = {0}, Num_Array[ARRAY_LEN] = {0};
-    uint8_t *pStr = Str_Array;
+    // Sign + 10 digits + NUL; filled from the end, so no reversal pass
+    char Str_Array[12];
+    char *pStr = Str_Array + sizeof(Str_Array) - 1;
+    uint32_t Magnitude = (Nummber < 0) ? 0u - (uint32_t)Nummber : (uint32_t)Nummber;
 
     if (Xpoint > Paint.Width || Ypoint > Paint.Height) {
         Debug("Paint_DisNum Input exceeds the normal display range\r\n");
         return;
     }
 
-    //Converts a number to a string
-    while (Nummber) {
-        Num_Array[Num_Bit] = Nummber % 10 + '0';
-        Num_Bit++;
-        Nummber /= 10;
-    }
-
-    //The string is inverted
-    while (Num_Bit > 0) {
-        Str_Array[Str_Bit] = Num_Array[Num_Bit - 1];
-        Str_Bit ++;
-        Num_Bit --;
-    }
+    //Converts a number to a string; zero still gets its digit
+    *pStr = '\0';
+    do {
+        *--pStr = Magnitude % 10 + '0';
+        Magnitude /= 10;
+    } while (Magnitude);
+    if (Nummber < 0)
+        *--pStr = '-';
 
     //show
-    Paint_DrawString_EN(Xpoint, Ypoint, (const char*)pStr, Font, Color_Background, Color_Foreground);
+    Paint_DrawString_EN(Xpoint, Ypoint, pStr, Font, Color_Background, Color_Foreground);
 }
 
 /******************************************************************************
@@ -655,6 +803,17 @@ void Paint_DrawBitMap(const unsigned char* image_buffer)
     UWORD x, y;
     UDOUBLE Addr = 0;
 
+    // A raw buffer copy; under a clip it goes through the pixel path instead
+    if (Paint.ClipX0 != 0 || Paint.ClipY0 != 0 ||
+        Paint.ClipX1 != Paint.Width || Paint.ClipY1 != Paint.Height) {
+        if (Paint.Rotate != ROTATE_0 || Paint.Mirror != MIRROR_NONE || Paint.Scale != 2) {
+            Debug("Paint_DrawBitMap: clipped copy needs an unrotated 1bpp image\r\n");
+            return;
+        }
+        Paint_DrawImage(image_buffer, 0, 0, Paint.WidthMemory, Paint.HeightMemory);
+        return;
+    }
+
     for (y = 0; y < Paint.HeightByte; y++) {
         for (x = 0; x < Paint.WidthByte; x++) {//8 pixel =  1 byte
             Addr = x + y * Paint.WidthByte;
@@ -677,8 +836,14 @@ void Paint_DrawImage(const unsigned char *image_buffer, UWORD xStart, UWORD ySta
     UWORD x, y;
     UWORD byte_width = (W_Image % 8) ? (W_Image / 8 + 1) : (W_Image / 8);
 
-    for (y = 0; y < H_Image; y++) {
-        for (x = 0; x < W_Image; x++) {
+    // Only the part inside the clip is visited
+    int x_first = Paint.ClipX0 > xStart ? Paint.ClipX0 - xStart : 0;
+    int y_first = Paint.ClipY0 > yStart ? Paint.ClipY0 - yStart : 0;
+    int x_end = Paint.ClipX1 - xStart < W_Image ? Paint.ClipX1 - xStart : W_Image;
+    int y_end = Paint.ClipY1 - yStart < H_Image ? Paint.ClipY1 - yStart : H_Image;
+
+    for (y = y_first; (int)y < y_end; y++) {
+        for (x = x_first; (int)x < x_end; x++) {
             // Each bit is a pixel: calculate byte and bit position
             UWORD byte_index = (y * byte_width) + (x / 8);
             UBYTE byte = image_buffer[byte_index];
@@ -686,7 +851,68 @@ void Paint_DrawImage(const unsigned char *image_buffer, UWORD xStart, UWORD ySta
 
             UWORD color = (byte & bit) ? WHITE : BLACK;
 
-            Paint_SetPixel(xStart + x, yStart + y, color);
+            Paint_PutPixel(xStart + x, yStart + y, color);
+        }
+    }
+}
+
+/******************************************************************************
+function:	Draw a pre-rasterized sprite
+parameter:
+    sprite           ：MSB-first 1bpp rows padded to whole bytes, 1 = white
+    xStart           : X of the top-left pixel, may be off-canvas
+    yStart           : Y of the top-left pixel, may be off-canvas
+    W_Sprite         ：Sprite width
+    H_Sprite         : Sprite height
+info:
+    Transparent: only the black pixels are drawn, clipped to the clip
+    rectangle. Unrotated, unmirrored 1bpp canvases take whole source bytes
+    at a time; anything else goes pixel by pixel.
+******************************************************************************/
+void Paint_DrawSprite(const unsigned char *sprite, int xStart, int yStart, UWORD W_Sprite, UWORD H_Sprite)
+{
+    int byte_width = (W_Sprite + 7) / 8;
+    UBYTE last_mask = (W_Sprite % 8) ? (UBYTE)(0xFF << (8 - W_Sprite % 8)) : 0xFF;
+    int y_first = Paint.ClipY0 > yStart ? Paint.ClipY0 - yStart : 0;
+    int y_end = Paint.ClipY1 - yStart < H_Sprite ? Paint.ClipY1 - yStart : H_Sprite;
+
+    if (Paint.Rotate != ROTATE_0 || Paint.Mirror != MIRROR_NONE || Paint.Scale != 2) {
+        int x_first = Paint.ClipX0 > xStart ? Paint.ClipX0 - xStart : 0;
+        int x_end = Paint.ClipX1 - xStart < W_Sprite ? Paint.ClipX1 - xStart : W_Sprite;
+        for (int y = y_first; y < y_end; y++)
+            for (int x = x_first; x < x_end; x++)
+                if (!(sprite[y * byte_width + x / 8] & (0x80 >> (x % 8))))
+                    Paint_PutPixel(xStart + x, yStart + y, BLACK);
+        return;
+    }
+
+    // Floor division: sprites may hang off the left edge
+    int dst_byte = (xStart >= 0) ? xStart / 8 : -((7 - xStart) / 8);
+    int shift = xStart - dst_byte * 8;
+
+    // Destination bytes the sprite covers, trimmed to the clip, with the
+    // clip's partial bytes at either end masked
+    int first = Paint.ClipX0 / 8, last = (Paint.ClipX1 - 1) / 8;
+    if (Paint.ClipX1 <= Paint.ClipX0)
+        return;
+    UBYTE first_mask = 0xFF >> (Paint.ClipX0 % 8);
+    UBYTE last_clip = 0xFF << (7 - (Paint.ClipX1 - 1) % 8);
+
+    for (int y = y_first; y < y_end; y++) {
+        UBYTE *row = Paint.Image + (UDOUBLE)(yStart + y) * Paint.WidthByte;
+        const unsigned char *src = sprite + y * byte_width;
+        for (int i = 0; i < byte_width; i++) {
+            UBYTE ink = ~src[i] & (i == byte_width - 1 ? last_mask : 0xFF);
+            if (!ink) continue;
+            // Black pixels straddle two framebuffer bytes unless aligned
+            for (int half = 0; half < (shift ? 2 : 1); half++) {
+                int b = dst_byte + i + half;
+                if (b < first || b > last) continue;
+                UBYTE bits = half ? (UBYTE)(ink << (8 - shift)) : (UBYTE)(ink >> shift);
+                if (b == first) bits &= first_mask;
+                if (b == last) bits &= last_clip;
+                row[b] &= ~bits;
+            }
         }
     }
 }
@@ -17,9 +17,17 @@ typedef struct {
     UWORD WidthByte;
     UWORD HeightByte;
     UWORD Scale;
+    // Active clip rectangle in drawing (rotated) coordinates, end exclusive
+    UWORD ClipX0;
+    UWORD ClipY0;
+    UWORD ClipX1;
+    UWORD ClipY1;
+    UBYTE ClipDepth;
 } PAINT;
 extern PAINT Paint;
 
+#define PAINT_CLIP_DEPTH    8
+
 #define ROTATE_0            0
 #define ROTATE_90           90
 #define ROTATE_180          180
@@ -84,6 +92,13 @@ void Paint_SetScale(UBYTE scale);
 void Paint_Clear(UWORD Color);
 void Paint_ClearWindows(UWORD Xstart, UWORD Ystart, UWORD Xend, UWORD Yend, UWORD Color);
 
+// Clipping: every drawing call, Paint_SetPixel and Paint_Clear included,
+// only touches the top of the clip stack (the whole image when it is
+// empty). End coordinates are exclusive, as in Paint_ClearWindows.
+UBYTE Paint_PushClip(UWORD Xstart, UWORD Ystart, UWORD Xend, UWORD Yend);
+void Paint_PopClip(void);
+void Paint_ResetClip(void);
+
 // Drawing
 void Paint_DrawPoint(UWORD Xpoint, UWORD Ypoint, UWORD Color, DOT_PIXEL Dot_Pixel, DOT_STYLE Dot_FillWay);
 void Paint_DrawLine(UWORD Xstart, UWORD Ystart, UWORD Xend, UWORD Yend, UWORD Color, DOT_PIXEL Line_width, LINE_STYLE Line_Style);
@@ -98,5 +113,6 @@ void Paint_DrawNum(UWORD Xpoint, UWORD Ypoint, int32_t Nummber, sFONT* Font, UWO
 // Bitmap
 void Paint_DrawBitMap(const unsigned char* image_buffer);
 void Paint_DrawImage(const unsigned char *image_buffer, UWORD xStart, UWORD yStart, UWORD W_Image, UWORD H_Image);
+void Paint_DrawSprite(const unsigned char *sprite, int xStart, int yStart, UWORD W_Sprite, UWORD H_Sprite);
 
 #endif
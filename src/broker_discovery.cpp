@@ -0,0 +1,187 @@
+#include "broker_discovery.h"
+
+#include <Arduino.h>
+#include <ESPmDNS.h>
+#include <Preferences.h>
+#include <WiFi.h>
+
+#include <atomic>
+
+#define BROKER_NAMESPACE   "broker"
+#define BROKER_CACHE_MAGIC 0x42524B31   // "BRK1"
+#define BROKER_RETRY_MS    60000        // earliest re-browse after running out of brokers
+
+namespace {
+
+struct BrokerCache {
+    uint32_t magic = 0;
+    uint8_t  count = 0;
+    Broker   list[BROKER_MAX] = {};
+};
+
+enum BrowseState : uint8_t { BROWSE_IDLE, BROWSE_RUNNING, BROWSE_DONE };
+
+// Owned by loop()
+BrokerCache   ranked;
+uint8_t       current = 0;       // index into ranked.list; == count is the configured server
+uint8_t       fails = 0;
+unsigned long browse_started = 0;
+unsigned long next_browse = 0;   // millis() deadline; 0 = browse as soon as WiFi is up
+const char   *mdns_host = "";
+
+// Filled by the browse task, handed to loop() by the DONE store
+Broker               found[BROKER_MAX];
+uint8_t              found_count = 0;
+std::atomic<uint8_t> browse{BROWSE_IDLE};
+
+bool sameList(const BrokerCache &a, const BrokerCache &b) {
+    if (a.count != b.count) return false;
+    for (int i = 0; i < a.count; i++)
+        if (a.list[i].ip != b.list[i].ip || a.list[i].port != b.list[i].port) return false;
+    return true;
+}
+
+// Browse, then time a TCP connect to every answer. Runs on its own task:
+// queryService() alone blocks for its full 3 s collection window.
+void browseTask(void *) {
+    static bool mdns_up = false;
+    if (!mdns_up) mdns_up = MDNS.begin(mdns_host);
+
+    found_count = 0;
+    int n = mdns_up ? MDNS.queryService("mqtt", "tcp") : 0;
+    for (int i = 0; i < n && found_count < BROKER_MAX; i++) {
+        IPAddress ip = MDNS.address(i);
+        uint16_t port = MDNS.port(i);
+        if ((uint32_t)ip == 0 || port == 0) continue;
+
+        WiFiClient probe;
+        unsigned long t0 = millis();
+        if (!probe.connect(ip, port, BROKER_PROBE_TIMEOUT_MS)) continue;   // advertised, unreachable
+        unsigned long rtt = millis() - t0;
+        probe.stop();
+
+        // Insertion keeps the list sorted by connect time
+        int at = found_count++;
+        while (at > 0 && found[at - 1].rtt_ms > rtt) {
+            found[at] = found[at - 1];
+            at--;
+        }
+        found[at] = { (uint32_t)ip, port, (uint16_t)(rtt > 65535 ? 65535 : rtt) };
+    }
+
+    browse.store(BROWSE_DONE, std::memory_order_release);
+    vTaskDelete(nullptr);
+}
+
+void saveCache() {
+    Preferences prefs;
+    if (!prefs.begin(BROKER_NAMESPACE, false)) return;
+    prefs.putBytes("ranked", &ranked, sizeof(BrokerCache));
+    prefs.end();
+}
+
+// Takes over a finished browse. An empty answer keeps the old ranking: mDNS
+// can be filtered on some networks while the cached broker still works.
+bool adopt(bool mqtt_up) {
+    Serial.printf("MDNS: %u broker(s) in %lums\n", found_count, millis() - browse_started);
+    if (found_count == 0) return false;
+
+    Broker prev;
+    bool had = brokerSelected(&prev);
+
+    BrokerCache fresh;
+    fresh.magic = BROKER_CACHE_MAGIC;
+    fresh.count = found_count;
+    memcpy(fresh.list, found, found_count * sizeof(Broker));
+    for (int i = 0; i < fresh.count; i++)
+        Serial.printf("MDNS:   %s:%u %ums\n", IPAddress(fresh.list[i].ip).toString().c_str(),
+                      fresh.list[i].port, fresh.list[i].rtt_ms);
+
+    // Only the order matters for the cache; RTT jitter alone is no reason to write flash
+    bool changed = !sameList(fresh, ranked);
+    ranked = fresh;
+    if (changed) saveCache();
+
+    // A working connection stays where it is; otherwise back to the configured server
+    current = ranked.count;
+    if (mqtt_up && had) {
+        for (int i = 0; i < ranked.count; i++)
+            if (ranked.list[i].ip == prev.ip && ranked.list[i].port == prev.port) current = i;
+    }
+    fails = 0;
+
+    Broker now;
+    bool has = brokerSelected(&now);
+    return has != had || (has && (now.ip != prev.ip || now.port != prev.port));
+}
+
+}  // namespace
+
+void brokerInit(const char *hostname) {
+    mdns_host = hostname;
+    Preferences prefs;
+    if (!prefs.begin(BROKER_NAMESPACE, true)) return;
+    if (prefs.getBytesLength("ranked") == sizeof(BrokerCache))
+        prefs.getBytes("ranked", &ranked, sizeof(BrokerCache));
+    prefs.end();
+    if (ranked.magic != BROKER_CACHE_MAGIC || ranked.count > BROKER_MAX) ranked = BrokerCache();
+    current = ranked.count;   // configured server first
+    if (ranked.count)
+        Serial.printf("MDNS: cached failover broker %s:%u\n",
+                      IPAddress(ranked.list[0].ip).toString().c_str(), ranked.list[0].port);
+}
+
+bool brokerTick(bool wifi_up, bool mqtt_up) {
+    uint8_t state = browse.load(std::memory_order_acquire);
+    if (state == BROWSE_DONE) {
+        browse.store(BROWSE_IDLE, std::memory_order_relaxed);
+        return adopt(mqtt_up);
+    }
+    if (state != BROWSE_IDLE || !wifi_up) return false;
+
+    unsigned long now = millis();
+    if (next_browse != 0 && (long)(now - next_browse) < 0) return false;
+
+    browse_started = now;
+    next_browse = now + BROKER_REFRESH_MS;
+    if (next_browse == 0) next_browse = 1;
+    browse.store(BROWSE_RUNNING, std::memory_order_relaxed);
+    if (xTaskCreate(browseTask, "mdns", BROKER_TASK_STACK, nullptr, 1, nullptr) != pdPASS) {
+        browse.store(BROWSE_IDLE, std::memory_order_relaxed);
+        next_browse = now + BROKER_RETRY_MS;
+        Serial.println("MDNS: browse task failed to start");
+    }
+    return false;
+}
+
+bool brokerSelected(Broker *out) {
+    if (current >= ranked.count) return false;
+    *out = ranked.list[current];
+    return true;
+}
+
+void brokerConnected() {
+    fails = 0;
+}
+
+bool brokerFailed() {
+    if (++fails < BROKER_FAILOVER_AFTER) return false;
+    fails = 0;
+    // Out of candidates: look again soon, rather than at the next refresh
+    if (ranked.count == 0 || current + 1 == ranked.count) next_browse = browse_started + BROKER_RETRY_MS;
+    if (next_browse == 0) next_browse = 1;
+    if (ranked.count == 0) return false;   // only the configured server to begin with
+
+    current = (current + 1) % (ranked.count + 1);
+    if (current == ranked.count)
+        Serial.println("MDNS: no discovered broker answers, using configured server");
+    else
+        Serial.printf("MDNS: failing over to %s:%u\n",
+                      IPAddress(ranked.list[current].ip).toString().c_str(),
+                      ranked.list[current].port);
+    return true;
+}
+
+int brokerCount() {
+    return ranked.count;
+}
@@ -0,0 +1,45 @@
+#pragma once
+// MQTT broker discovery over mDNS/DNS-SD (_mqtt._tcp).
+//
+// A background task browses for brokers, times a plain TCP connect to each
+// and ranks them fastest first. The ranked list is cached in NVS (namespace
+// "broker"), so after a reboot the failover candidates are known straight
+// away while a fresh browse runs behind it; nothing on the boot or reconnect
+// path ever waits for mDNS.
+//
+// The configured mqtt_server always comes first. BROKER_FAILOVER_AFTER
+// connect failures in a row move on to the next candidate: the ranked
+// brokers in order, then mqtt_server again and a new browse. Callers only
+// enable this with TLS, since a browse answer proves nothing about a host.
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define BROKER_MAX              4
+#define BROKER_FAILOVER_AFTER   3
+#define BROKER_PROBE_TIMEOUT_MS 500
+#define BROKER_REFRESH_MS       (6UL * 3600 * 1000)   // re-browse, picks up new brokers
+#define BROKER_TASK_STACK       4096
+
+struct Broker {
+    uint32_t ip;        // IPv4, as IPAddress stores it
+    uint16_t port;
+    uint16_t rtt_ms;    // TCP connect time when last probed
+};
+
+// Loads the cached ranking; `hostname` is announced over mDNS
+void brokerInit(const char *hostname);
+
+// Call from loop(). Starts a browse when one is due, adopts finished
+// results. Returns true when the selected broker changed.
+bool brokerTick(bool wifi_up, bool mqtt_up);
+
+// Current pick; false means "use the configured mqtt_server"
+bool brokerSelected(Broker *out);
+
+// Connect outcome for the current pick. brokerFailed() returns true when
+// it switched to another candidate.
+void brokerConnected();
+bool brokerFailed();
+
+int  brokerCount();
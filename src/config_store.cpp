@@ -0,0 +1,311 @@
+#include "config_store.h"
+
+#include <Arduino.h>
+#include <Preferences.h>
+#include <ctype.h>
+
+#include "config.h"
+
+#define CFG_NAMESPACE      "cfg"
+#define CFG_GOOD_NAMESPACE "cfg_good"   // network fields that last connected, while on trial
+#define CFG_VALUE_MAX      64
+#define CFG_NET_EFFECTS    (CFG_EFFECT_WIFI | CFG_EFFECT_MQTT)
+
+#ifndef MQTT_MDNS   // config.h files from before broker discovery
+#define MQTT_MDNS 0
+#endif
+
+namespace {
+
+enum FieldType : uint8_t { F_U32, F_STR, F_ID };
+
+struct Field {
+    const char *key;       // JSON and NVS key (NVS allows 15 chars)
+    FieldType   type;
+    uint16_t    offset;
+    uint16_t    size;      // string capacity including NUL
+    uint32_t    min, max;  // value range, or string length range
+    uint8_t     effect;
+    bool        secret;
+    const char *def_str;
+    uint32_t    def_u32;
+};
+
+#define STR(f, lo, eff, sec, def) \
+    { #f, F_STR, offsetof(Config, f), sizeof(Config::f), lo, sizeof(Config::f) - 1, eff, sec, def, 0 }
+#define U32(f, lo, hi, eff, def) \
+    { #f, F_U32, offsetof(Config, f), 0, lo, hi, eff, false, nullptr, def }
+
+const Field fields[] = {
+    STR(wifi_ssid,   1, CFG_EFFECT_WIFI, false, WIFI_SSID),
+    STR(wifi_pass,   0, CFG_EFFECT_WIFI, true,  WIFI_PASSWORD),
+    STR(mqtt_server, 1, CFG_EFFECT_MQTT, false, MQTT_SERVER),
+    U32(mqtt_port,   1, 65535, CFG_EFFECT_MQTT, MQTT_PORT),
+    U32(mqtt_mdns,   0, 1,     CFG_EFFECT_MQTT, MQTT_MDNS),
+    { "device_id", F_ID, offsetof(Config, device_id), sizeof(Config::device_id),
+      1, sizeof(Config::device_id) - 1, CFG_EFFECT_REBOOT, false, DEVICE_ID, 0 },
+    U32(sensor_ms,   10000, 3600000, 0, 120000),
+    U32(home_ms,     10000, 3600000, 0, 60000),
+    U32(detail_ms,   5000,  600000,  0, 25000),
+    U32(full_every,  1,     100,     0, 5),
+    U32(co2_max,     500,   10000,   0, 2000),
+};
+constexpr size_t FIELD_COUNT = sizeof(fields) / sizeof(fields[0]);
+
+#undef STR
+#undef U32
+
+Config   values;
+char     err_buf[48];
+uint32_t trial_hash  = 0;   // update whose network fields are on trial; 0 = none
+uint32_t failed_hash = 0;   // update that was reverted; refused when redelivered
+
+char *strAt(Config &c, const Field &f)  { return (char *)&c + f.offset; }
+uint32_t &u32At(Config &c, const Field &f) { return *(uint32_t *)((char *)&c + f.offset); }
+
+// Finds "key": and copies its value (string contents or bare number).
+// No escape handling: config values never need quotes or backslashes.
+bool findValue(const char *json, const char *key, char *out, bool *quoted) {
+    char search[24];
+    snprintf(search, sizeof(search), "\"%s\":", key);
+    const char *p = strstr(json, search);
+    if (!p) return false;
+    p += strlen(search);
+    while (*p == ' ') p++;
+    *quoted = *p == '"';
+    const char *end;
+    if (*quoted) {
+        p++;
+        end = strchr(p, '"');
+        if (!end) return false;
+    } else {
+        end = p;
+        while ((*end >= '0' && *end <= '9') || *end == '-' || *end == 't' ||
+               *end == 'r' || *end == 'u' || *end == 'e') end++;
+    }
+    size_t len = end - p;
+    if (len >= CFG_VALUE_MAX) len = CFG_VALUE_MAX - 1;
+    memcpy(out, p, len);
+    out[len] = '\0';
+    return true;
+}
+
+bool idChars(const char *s) {
+    for (; *s; s++)
+        if (!isalnum((unsigned char)*s) && *s != '-' && *s != '_') return false;
+    return true;
+}
+
+// Parses and range-checks one raw value into `into`
+bool parseField(const Field &f, const char *raw, bool quoted, Config &into) {
+    if (f.type == F_U32) {
+        if (quoted || !*raw || *raw == '-') return false;
+        char *end;
+        unsigned long v = strtoul(raw, &end, 10);
+        if (*end || v < f.min || v > f.max) return false;
+        u32At(into, f) = (uint32_t)v;
+        return true;
+    }
+    size_t len = strlen(raw);
+    if (!quoted || len < f.min || len > f.max) return false;
+    if (f.type == F_ID && !idChars(raw)) return false;
+    memcpy(strAt(into, f), raw, len + 1);
+    return true;
+}
+
+void setDefaults(Config &c) {
+    for (const Field &f : fields) {
+        if (f.type == F_U32) u32At(c, f) = f.def_u32;
+        else snprintf(strAt(c, f), f.size, "%s", f.def_str);
+    }
+}
+
+bool sameValue(const Field &f, Config &a, Config &b) {
+    if (f.type == F_U32) return u32At(a, f) == u32At(b, f);
+    return strcmp(strAt(a, f), strAt(b, f)) == 0;
+}
+
+void putField(Preferences &prefs, const Field &f, Config &c) {
+    if (f.type == F_U32) prefs.putUInt(f.key, u32At(c, f));
+    else prefs.putString(f.key, strAt(c, f));
+}
+
+// Reads one stored field through the same validation as a remote value
+bool getField(Preferences &prefs, const Field &f, Config &into) {
+    char raw[CFG_VALUE_MAX];
+    if (f.type == F_U32) {
+        snprintf(raw, sizeof(raw), "%lu", (unsigned long)prefs.getUInt(f.key));
+        return parseField(f, raw, false, into);
+    }
+    raw[0] = '\0';
+    prefs.getString(f.key, raw, sizeof(raw));
+    return parseField(f, raw, true, into);
+}
+
+// FNV-1a; tells a redelivered update from a new one
+uint32_t hashText(const char *s) {
+    uint32_t h = 2166136261u;
+    for (; *s; s++) h = (h ^ (uint8_t)*s) * 16777619u;
+    return h ? h : 1;
+}
+
+}  // namespace
+
+const Config &config = values;
+
+void configLoad() {
+    setDefaults(values);
+    Preferences prefs;
+    if (!prefs.begin(CFG_NAMESPACE, true)) return;   // nothing stored yet
+
+    int overrides = 0;
+    for (const Field &f : fields) {
+        if (!prefs.isKey(f.key)) continue;
+        if (getField(prefs, f, values)) overrides++;
+        else Serial.printf("CFG: stored %s invalid, using default\n", f.key);
+    }
+    prefs.end();
+    Serial.printf("CFG: %d override(s) from NVS\n", overrides);
+
+    if (!prefs.begin(CFG_GOOD_NAMESPACE, true)) return;
+    trial_hash  = prefs.getUInt("trial", 0);
+    failed_hash = prefs.getUInt("failed", 0);
+    prefs.end();
+    if (trial_hash) Serial.println("CFG: network settings still on trial");
+}
+
+bool configUpdate(const char *json, uint8_t *effects, const char **err) {
+    *effects = 0;
+    *err = "";
+
+    uint32_t hash = hashText(json);
+    if (hash == failed_hash) {
+        *err = "network settings did not connect, reverted";
+        return false;
+    }
+
+    char raw[CFG_VALUE_MAX];
+    bool quoted;
+    bool reset = findValue(json, "reset", raw, &quoted) && strcmp(raw, "true") == 0;
+    Config defaults, next;
+    setDefaults(defaults);
+    next = reset ? defaults : values;
+
+    for (const Field &f : fields) {
+        if (!findValue(json, f.key, raw, &quoted)) continue;
+        if (!parseField(f, raw, quoted, next)) {
+            snprintf(err_buf, sizeof(err_buf), "invalid %s", f.key);
+            *err = err_buf;
+            return false;
+        }
+    }
+
+    // The retained topic is redelivered on every reconnect; an update that
+    // changes nothing must not touch flash
+    int changed = 0;
+    uint8_t net = 0;
+    for (const Field &f : fields) {
+        if (sameValue(f, next, values)) continue;
+        changed++;
+        net |= f.effect & CFG_NET_EFFECTS;
+    }
+    if (changed == 0) return true;
+
+    Preferences prefs;
+    if (net) {
+        // Snapshot the settings that work before replacing them; an update
+        // arriving mid-trial keeps the snapshot it already has
+        if (!prefs.begin(CFG_GOOD_NAMESPACE, false)) {
+            *err = "nvs unavailable";
+            return false;
+        }
+        if (!trial_hash)
+            for (const Field &f : fields)
+                if (f.effect & CFG_NET_EFFECTS) putField(prefs, f, values);
+        trial_hash = hash;
+        prefs.putUInt("trial", trial_hash);
+        prefs.end();
+    }
+    if (!prefs.begin(CFG_NAMESPACE, false)) {
+        *err = "nvs unavailable";
+        return false;
+    }
+    if (reset) prefs.clear();
+    for (const Field &f : fields) {
+        bool differs = !sameValue(f, next, values);
+        if (differs) {
+            *effects |= f.effect;
+            Serial.printf("CFG: %s changed\n", f.key);
+        }
+        // After a reset only values that differ from the defaults are kept
+        if (reset ? sameValue(f, next, defaults) : !differs) continue;
+        putField(prefs, f, next);
+    }
+    prefs.end();
+    values = next;
+    return true;
+}
+
+size_t configDescribe(char *out, size_t out_sz) {
+    size_t n = 0;
+    out[0] = '\0';
+    for (size_t i = 0; i < FIELD_COUNT && n < out_sz; i++) {
+        const Field &f = fields[i];
+        const char *sep = n ? "," : "{";
+        if (f.secret)
+            continue;
+        if (f.type == F_U32)
+            n += snprintf(out + n, out_sz - n, "%s\"%s\":%lu", sep, f.key,
+                          (unsigned long)u32At(values, f));
+        else
+            n += snprintf(out + n, out_sz - n, "%s\"%s\":\"%s\"", sep, f.key, strAt(values, f));
+    }
+    if (n < out_sz) n += snprintf(out + n, out_sz - n, "}");
+    return n < out_sz ? n : 0;
+}
+
+bool configProvisional() {
+    return trial_hash != 0;
+}
+
+void configConfirm() {
+    if (!trial_hash) return;
+    trial_hash = 0;
+    Preferences prefs;
+    if (!prefs.begin(CFG_GOOD_NAMESPACE, false)) return;
+    for (const Field &f : fields)
+        if (f.effect & CFG_NET_EFFECTS) prefs.remove(f.key);
+    prefs.remove("trial");
+    prefs.end();
+}
+
+void configRevert(uint8_t *effects) {
+    *effects = 0;
+    if (!trial_hash) return;
+    Preferences good;
+    if (!good.begin(CFG_GOOD_NAMESPACE, false)) return;
+    Config next = values;
+    for (const Field &f : fields)
+        if ((f.effect & CFG_NET_EFFECTS) && good.isKey(f.key) && !getField(good, f, next))
+            Serial.printf("CFG: saved %s invalid, keeping current\n", f.key);
+
+    Preferences prefs;
+    if (prefs.begin(CFG_NAMESPACE, false)) {
+        for (const Field &f : fields) {
+            if (sameValue(f, next, values)) continue;
+            *effects |= f.effect;
+            putField(prefs, f, next);
+            Serial.printf("CFG: %s reverted\n", f.key);
+        }
+        prefs.end();
+    }
+    values = next;
+
+    failed_hash = trial_hash;
+    trial_hash = 0;
+    for (const Field &f : fields)
+        if (f.effect & CFG_NET_EFFECTS) good.remove(f.key);
+    good.remove("trial");
+    good.putUInt("failed", failed_hash);
+    good.end();
+}
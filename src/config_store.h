@@ -0,0 +1,62 @@
+#pragma once
+// Runtime configuration. Defaults come from config.h, overrides live in NVS
+// (namespace "cfg", one key per field) and arrive remotely as JSON on the
+// retained <device>/config topic:
+//
+//   {"sensor_ms":60000,"home_ms":30000,"co2_max":1500}
+//
+// An update is validated as a whole before anything is stored, and only
+// fields whose value actually changed are written back. {"reset":true}
+// drops every override.
+//
+// Network fields (CFG_EFFECT_WIFI / CFG_EFFECT_MQTT) are provisional when
+// they change: the values that last reached the broker are kept in NVS
+// (namespace "cfg_good") until the new ones connect. If they never do, the
+// caller reverts, and the same update redelivered by the retained topic is
+// refused from then on, so one typo cannot strand the unit.
+
+#include <stddef.h>
+#include <stdint.h>
+
+struct Config {
+    char     wifi_ssid[33];
+    char     wifi_pass[64];
+    char     mqtt_server[64];
+    uint32_t mqtt_port;
+    uint32_t mqtt_mdns;      // 1: fail over to brokers found over mDNS (TLS builds only)
+    char     device_id[32];
+    uint32_t sensor_ms;      // read + publish sensors
+    uint32_t home_ms;        // re-render home with fresh data
+    uint32_t detail_ms;      // auto-return from detail screens
+    uint32_t full_every;     // full e-ink waveform every N transitions
+    uint32_t co2_max;        // top of the CO2 bar, ppm
+};
+
+// What a changed field needs before it is in effect; everything else is
+// read at its point of use and applies immediately.
+#define CFG_EFFECT_WIFI    0x01   // rejoin with new credentials
+#define CFG_EFFECT_MQTT    0x02   // reconnect to the broker
+#define CFG_EFFECT_REBOOT  0x04   // only picked up at boot
+
+extern const Config &config;
+
+void configLoad();
+
+// Returns false (and leaves everything untouched) if any field is invalid;
+// *err names the first offender. *effects collects CFG_EFFECT_* of the
+// fields that changed.
+bool configUpdate(const char *json, uint8_t *effects, const char **err);
+
+// Current values as JSON, secrets omitted; 0 if they don't fit in out_sz
+size_t configDescribe(char *out, size_t out_sz);
+
+// True while changed network settings have not reached the broker yet;
+// survives a reboot
+bool configProvisional();
+
+// The provisional settings connected: they become the last-known-good ones
+void configConfirm();
+
+// Back to the last-known-good network settings. *effects collects
+// CFG_EFFECT_* of the fields that changed back.
+void configRevert(uint8_t *effects);
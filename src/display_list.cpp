@@ -0,0 +1,242 @@
+#include "display_list.h"
+
+#include <string.h>
+#include <qrcode.h>
+
+#include "GUI_Paint.h"
+#include "dither.h"
+
+#define DL_TEXT_MAX 63
+#define DL_QR_MAX   134   // version 6, ECC low, byte mode
+
+namespace {
+
+struct Reader {
+    const uint8_t *p, *end;
+    bool ok = true;
+
+    uint8_t u8() {
+        if (p >= end) { ok = false; return 0; }
+        return *p++;
+    }
+    uint16_t u16() {
+        if (end - p < 2) { ok = false; p = end; return 0; }
+        uint16_t v = (uint16_t)(p[0] | (p[1] << 8));
+        p += 2;
+        return v;
+    }
+    const uint8_t *bytes(size_t n) {
+        if ((size_t)(end - p) < n) { ok = false; p = end; return nullptr; }
+        const uint8_t *r = p;
+        p += n;
+        return r;
+    }
+};
+
+struct Box {
+    uint16_t w, h;
+    DrawResult *res;
+
+    // Inclusive pixel bounds; false if any part falls off the panel
+    bool fits(int x0, int y0, int x1, int y1) const {
+        return x0 >= 0 && y0 >= 0 && x1 < w && y1 < h && x0 <= x1 && y0 <= y1;
+    }
+    void touch(int x0, int y0, int x1, int y1) {
+        if (res->x0 == res->x1) {
+            res->x0 = x0; res->y0 = y0; res->x1 = x1 + 1; res->y1 = y1 + 1;
+            return;
+        }
+        if (x0 < res->x0) res->x0 = x0;
+        if (y0 < res->y0) res->y0 = y0;
+        if (x1 + 1 > res->x1) res->x1 = x1 + 1;
+        if (y1 + 1 > res->y1) res->y1 = y1 + 1;
+    }
+};
+
+bool colour(uint8_t c, UWORD *out) {
+    if (c > 1) return false;
+    *out = c ? WHITE : BLACK;
+    return true;
+}
+
+sFONT *font(uint8_t id) {
+    switch (id) {
+        case 0: return &Font16;
+        case 1: return &Font20;
+        case 2: return &Font24;
+    }
+    return nullptr;
+}
+
+bool penWidth(uint8_t w) {
+    return w >= DOT_PIXEL_1X1 && w <= DOT_PIXEL_8X8;
+}
+
+}  // namespace
+
+// One pass over the list; with `draw` false it only checks every op and
+// computes the box, leaving the Paint image alone
+static DrawStatus run(const uint8_t *data, size_t len, const DrawEnv &env, DrawResult *out, bool draw) {
+    memset(out, 0, sizeof(*out));
+    if (len < DL_HEADER_LEN || data[0] != DL_MAGIC) return DL_BAD_HEADER;
+    out->flags = data[1];
+    out->seq   = (uint16_t)(data[2] | (data[3] << 8));
+
+    Reader rd{data + DL_HEADER_LEN, data + len};
+    Box box{env.width, env.height, out};
+
+    if (out->flags & DL_FLAG_BLANK) {
+        if (draw) Paint_Clear(WHITE);
+        box.touch(0, 0, env.width - 1, env.height - 1);
+    }
+
+    while (rd.p < rd.end) {
+        uint8_t op = rd.u8();
+        if (op == DL_OP_END) break;
+
+        switch (op) {
+        case DL_OP_CLEAR: {
+            UWORD c;
+            uint8_t cv = rd.u8();
+            if (!rd.ok) return DL_TRUNCATED;
+            if (!colour(cv, &c)) return DL_BAD_ARG;
+            if (draw) Paint_Clear(c);
+            box.touch(0, 0, env.width - 1, env.height - 1);
+            break;
+        }
+        case DL_OP_TEXT: {
+            uint16_t x = rd.u16(), y = rd.u16();
+            uint8_t f = rd.u8(), fg = rd.u8(), bg = rd.u8(), n = rd.u8();
+            const uint8_t *s = rd.bytes(n);
+            if (!rd.ok) return DL_TRUNCATED;
+            sFONT *fnt = font(f);
+            UWORD ink, paper;
+            if (!fnt || n == 0 || n > DL_TEXT_MAX || !colour(fg, &ink) || !colour(bg, &paper))
+                return DL_BAD_ARG;
+            for (uint8_t i = 0; i < n; i++)
+                if (s[i] < ' ' || s[i] > '~') return DL_BAD_ARG;
+            // Must fit on one line: Paint_DrawString_EN would cut it off
+            int x1 = x + n * fnt->Width - 1, y1 = y + fnt->Height - 1;
+            if (!box.fits(x, y, x1, y1)) return DL_OUT_OF_BOUNDS;
+            for (uint8_t i = 0; draw && i < n; i++)
+                Paint_DrawChar(x + i * fnt->Width, y, (char)s[i], fnt, ink, paper);
+            box.touch(x, y, x1, y1);
+            break;
+        }
+        case DL_OP_RECT:
+        case DL_OP_LINE: {
+            uint16_t x1 = rd.u16(), y1 = rd.u16(), x2 = rd.u16(), y2 = rd.u16();
+            uint8_t cv = rd.u8(), w = rd.u8(), mode = rd.u8();
+            if (!rd.ok) return DL_TRUNCATED;
+            UWORD c;
+            if (!colour(cv, &c) || !penWidth(w) || mode > 1) return DL_BAD_ARG;
+            int lo_x = x1 < x2 ? x1 : x2, hi_x = x1 < x2 ? x2 : x1;
+            int lo_y = y1 < y2 ? y1 : y2, hi_y = y1 < y2 ? y2 : y1;
+            // GUI_Paint's pen square reaches w pixels up/left of the path and w-2 down/right
+            if (!box.fits(lo_x - w, lo_y - w, hi_x + w - 2, hi_y + w - 2)) return DL_OUT_OF_BOUNDS;
+            if (op == DL_OP_RECT) {
+                if (x1 > x2 || y1 > y2) return DL_BAD_ARG;
+                if (draw) Paint_DrawRectangle(x1, y1, x2, y2, c, (DOT_PIXEL)w,
+                                    mode ? DRAW_FILL_FULL : DRAW_FILL_EMPTY);
+            } else if (draw) {
+                Paint_DrawLine(x1, y1, x2, y2, c, (DOT_PIXEL)w,
+                               mode ? LINE_STYLE_DOTTED : LINE_STYLE_SOLID);
+            }
+            box.touch(lo_x - w, lo_y - w, hi_x + w - 2, hi_y + w - 2);
+            break;
+        }
+        case DL_OP_CIRCLE: {
+            uint16_t cx = rd.u16(), cy = rd.u16(), r = rd.u16();
+            uint8_t cv = rd.u8(), w = rd.u8(), fill = rd.u8();
+            if (!rd.ok) return DL_TRUNCATED;
+            UWORD c;
+            if (!colour(cv, &c) || !penWidth(w) || fill > 1 || r == 0) return DL_BAD_ARG;
+            if (!box.fits(cx - r - w, cy - r - w, cx + r + w - 2, cy + r + w - 2)) return DL_OUT_OF_BOUNDS;
+            if (draw) Paint_DrawCircle(cx, cy, r, c, (DOT_PIXEL)w, fill ? DRAW_FILL_FULL : DRAW_FILL_EMPTY);
+            box.touch(cx - r - w, cy - r - w, cx + r + w - 2, cy + r + w - 2);
+            break;
+        }
+        case DL_OP_IMAGE: {
+            uint8_t id = rd.u8();
+            uint16_t x = rd.u16(), y = rd.u16();
+            if (!rd.ok) return DL_TRUNCATED;
+            if (id >= env.image_count) return DL_BAD_ARG;
+            const DrawImage &img = env.images[id];
+            if (!box.fits(x, y, x + img.w - 1, y + img.h - 1)) return DL_OUT_OF_BOUNDS;
+            if (draw) Paint_DrawImage(img.bits, x, y, img.w, img.h);
+            box.touch(x, y, x + img.w - 1, y + img.h - 1);
+            break;
+        }
+        case DL_OP_QR: {
+            uint16_t x = rd.u16(), y = rd.u16();
+            uint8_t px = rd.u8(), n = rd.u8();
+            const uint8_t *s = rd.bytes(n);
+            if (!rd.ok) return DL_TRUNCATED;
+            if (px == 0 || n == 0 || n > DL_QR_MAX) return DL_BAD_ARG;
+            int side = (4 * env.qr_version + 17) * px;
+            // 2px white quiet zone on every side
+            if (!box.fits(x - 2, y - 2, x + side + 2, y + side + 2)) return DL_OUT_OF_BOUNDS;
+
+            char text[DL_QR_MAX + 1];
+            memcpy(text, s, n);
+            text[n] = '\0';
+            QRCode qr;
+            if (qrcode_initText(&qr, env.qr_modules, env.qr_version, ECC_LOW, text) < 0)
+                return DL_BAD_ARG;
+            if (draw) {
+                Paint_DrawRectangle(x - 2, y - 2, x + side + 2, y + side + 2,
+                                    WHITE, DOT_PIXEL_1X1, DRAW_FILL_FULL);
+                for (int my = 0; my < qr.size; my++)
+                    for (int mx = 0; mx < qr.size; mx++)
+                        if (qrcode_getModule(&qr, mx, my))
+                            Paint_DrawRectangle(x + mx * px, y + my * px,
+                                                x + (mx + 1) * px - 1, y + (my + 1) * px - 1,
+                                                BLACK, DOT_PIXEL_1X1, DRAW_FILL_FULL);
+            }
+            box.touch(x - 2, y - 2, x + side + 2, y + side + 2);
+            break;
+        }
+        case DL_OP_GRAY: {
+            uint16_t x = rd.u16(), y = rd.u16(), w = rd.u16(), h = rd.u16();
+            uint8_t mode = rd.u8();
+            if (!rd.ok) return DL_TRUNCATED;
+            if (w == 0 || h == 0 || mode > DITHER_DIFFUSE) return DL_BAD_ARG;
+            const uint8_t *px = rd.bytes((size_t)w * h);
+            if (!rd.ok) return DL_TRUNCATED;
+            if (!box.fits(x, y, x + w - 1, y + h - 1)) return DL_OUT_OF_BOUNDS;
+            if (draw) {
+                // Straight into the 1 bpp image, one streaming pass
+                Ditherer d((DitherMode)mode, 1, w, env.dither_err);
+                for (uint16_t r = 0; r < h; r++)
+                    d.row(px + (size_t)r * w, Paint.Image + (size_t)(y + r) * Paint.WidthByte, x, y + r);
+            }
+            box.touch(x, y, x + w - 1, y + h - 1);
+            break;
+        }
+        default:
+            return DL_BAD_OP;
+        }
+        out->ops++;
+    }
+    return DL_OK;
+}
+
+DrawStatus drawListRun(const uint8_t *data, size_t len, const DrawEnv &env, DrawResult *out) {
+    // Check the whole list before touching the image, so a bad op never
+    // leaves the ones before it half-applied
+    DrawStatus st = run(data, len, env, out, false);
+    if (st != DL_OK) return st;
+    return run(data, len, env, out, true);
+}
+
+const char *drawStatusName(DrawStatus s) {
+    switch (s) {
+        case DL_OK:            return "ok";
+        case DL_BAD_HEADER:    return "bad_header";
+        case DL_TRUNCATED:     return "truncated";
+        case DL_BAD_OP:        return "bad_op";
+        case DL_OUT_OF_BOUNDS: return "out_of_bounds";
+        case DL_BAD_ARG:       return "bad_arg";
+    }
+    return "?";
+}
@@ -0,0 +1,81 @@
+#pragma once
+// Compact draw commands from the gateway, received on <device>/draw.
+// Each op maps 1:1 onto a GUI_Paint primitive and is bounds-checked before
+// it runs. The whole list is checked before any op draws, so a rejected list
+// leaves the image as it was.
+//
+// Header (little-endian):
+//    0  u8   magic 'D'
+//    1  u8   flags (DL_FLAG_*)
+//    2  u16  seq          shares the numbering of <device>/frame patches
+//
+// Ops (u16 coordinates, colour 0 = black / 1 = white):
+//   DL_OP_END     -
+//   DL_OP_CLEAR   colour
+//   DL_OP_TEXT    x y font fg bg len bytes[len]       font 0/1/2 = 16/20/24
+//   DL_OP_RECT    x1 y1 x2 y2 colour width fill
+//   DL_OP_LINE    x1 y1 x2 y2 colour width dotted
+//   DL_OP_CIRCLE  cx cy r colour width fill
+//   DL_OP_IMAGE   id x y                              built-in bitmap
+//   DL_OP_QR      x y px len bytes[len]               version 6, ECC low
+//   DL_OP_GRAY    x y w h mode bytes[w*h]             8-bit gray, 0 = black,
+//                                                     dithered on the device
+//
+// DL_OP_GRAY modes are DitherMode (dither.h): 0 Bayer, 1 Floyd-Steinberg.
+// Images larger than one message go in strips; Bayer strips join without a
+// seam, diffusion restarts its error row with every op.
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define DL_MAGIC        'D'
+#define DL_HEADER_LEN   4
+#define DL_FLAG_BLANK   0x01   // start from a white frame instead of the current one
+#define DL_FLAG_FULL    0x02   // refresh the whole panel, not just the touched box
+
+enum DrawOp : uint8_t {
+    DL_OP_END    = 0x00,
+    DL_OP_CLEAR  = 0x01,
+    DL_OP_TEXT   = 0x02,
+    DL_OP_RECT   = 0x03,
+    DL_OP_LINE   = 0x04,
+    DL_OP_CIRCLE = 0x05,
+    DL_OP_IMAGE  = 0x06,
+    DL_OP_QR     = 0x07,
+    DL_OP_GRAY   = 0x08,
+};
+
+enum DrawStatus {
+    DL_OK = 0,
+    DL_BAD_HEADER,
+    DL_TRUNCATED,      // op runs past the end of the payload
+    DL_BAD_OP,
+    DL_OUT_OF_BOUNDS,
+    DL_BAD_ARG,
+};
+
+struct DrawImage {
+    const unsigned char *bits;   // Paint_DrawImage format
+    uint16_t             w, h;
+};
+
+struct DrawEnv {
+    uint16_t         width, height;
+    const DrawImage *images;
+    uint8_t          image_count;
+    uint8_t         *qr_modules;    // qrcode workspace for QR_VERSION
+    uint8_t          qr_version;
+    int16_t         *dither_err;    // width + 2 values for DL_OP_GRAY diffusion; null: Bayer only
+};
+
+struct DrawResult {
+    uint8_t  flags;
+    uint16_t seq;
+    uint16_t ops;                    // ops executed (index of the failing op on error)
+    uint16_t x0, y0, x1, y1;         // touched box, end-exclusive; x0 == x1 when empty
+};
+
+// Executes into the currently selected Paint image.
+DrawStatus drawListRun(const uint8_t *data, size_t len, const DrawEnv &env, DrawResult *out);
+
+const char *drawStatusName(DrawStatus s);
@@ -0,0 +1,125 @@
+#include "dither.h"
+
+#include <string.h>
+
+// Bayer 8x8 index matrix, 0..63
+static const uint8_t bayer8[8][8] = {
+    {  0, 32,  8, 40,  2, 34, 10, 42 },
+    { 48, 16, 56, 24, 50, 18, 58, 26 },
+    { 12, 44,  4, 36, 14, 46,  6, 38 },
+    { 60, 28, 52, 20, 62, 30, 54, 22 },
+    {  3, 35, 11, 43,  1, 33,  9, 41 },
+    { 51, 19, 59, 27, 49, 17, 57, 25 },
+    { 15, 47,  7, 39, 13, 45,  5, 37 },
+    { 63, 31, 55, 23, 61, 29, 53, 21 },
+};
+
+// Offset t = 4 * index + 2 spread over 0..255; a pixel rounds up to the
+// next level when v * (levels - 1) + t reaches 255, so at 1 bpp it is
+// white from v = 253 - 4 * index
+static uint8_t offset(int y, int x) { return (uint8_t)(bayer8[y & 7][x & 7] * 4 + 2); }
+
+// Luminance level (0 = black .. 3 = white) to its 2 bpp code
+static const uint8_t gray_code[4] = { 0x0, 0x2, 0x1, 0x3 };
+
+// Top `n` bits of `v` (n = 1..8) at bit position `bit` of `dst`, leaving the
+// bits around them alone; touches at most two bytes
+static void putBits(uint8_t *dst, uint32_t bit, uint8_t v, uint8_t n) {
+    uint8_t *p = dst + (bit >> 3);
+    uint8_t s = bit & 7;
+    uint16_t mask = (uint16_t)((0xFF00u >> n) & 0xFF) << 8 >> s;
+    uint16_t val  = ((uint16_t)v << 8 >> s) & mask;
+    p[0] = (uint8_t)((p[0] & ~(mask >> 8)) | (val >> 8));
+    if (mask & 0xFF) p[1] = (uint8_t)((p[1] & ~mask) | (val & 0xFF));
+}
+
+Ditherer::Ditherer(DitherMode mode, uint8_t bpp, uint16_t w, int16_t *err)
+    : mode_(mode), bpp_(bpp == 2 ? 2 : 1), w_(w), err_(err) {
+    if (mode_ == DITHER_DIFFUSE && err_) memset(err_, 0, (w_ + 2) * sizeof(int16_t));
+}
+
+void Ditherer::row(const uint8_t *gray, uint8_t *dst, uint16_t x, uint16_t y) {
+    if (mode_ == DITHER_DIFFUSE && err_) {
+        diffuse(gray, dst, x);
+        rtl_ = !rtl_;
+    } else if (bpp_ == 1) {
+        bayer1(gray, dst, x, y);
+    } else {
+        bayer2(gray, dst, x, y);
+    }
+}
+
+// Eight compares per output byte against the row's thresholds, lined up
+// with the surface position so strips and offsets keep the pattern
+void Ditherer::bayer1(const uint8_t *gray, uint8_t *dst, uint16_t x, uint16_t y) {
+    uint8_t thr[8];
+    for (int i = 0; i < 8; i++) thr[i] = (uint8_t)(255 - offset(y, x + i));
+
+    uint16_t i = 0;
+    for (; i + 8 <= w_; i += 8) {
+        const uint8_t *g = gray + i;
+        uint8_t b = (uint8_t)((g[0] >= thr[0]) << 7 | (g[1] >= thr[1]) << 6 |
+                              (g[2] >= thr[2]) << 5 | (g[3] >= thr[3]) << 4 |
+                              (g[4] >= thr[4]) << 3 | (g[5] >= thr[5]) << 2 |
+                              (g[6] >= thr[6]) << 1 | (g[7] >= thr[7]));
+        if (((x + i) & 7) == 0) dst[(x + i) >> 3] = b;
+        else putBits(dst, x + i, b, 8);
+    }
+    if (i < w_) {
+        uint8_t b = 0, n = (uint8_t)(w_ - i);
+        for (uint8_t k = 0; k < n; k++) b |= (uint8_t)((gray[i + k] >= thr[k]) << (7 - k));
+        putBits(dst, x + i, b, n);
+    }
+}
+
+void Ditherer::bayer2(const uint8_t *gray, uint8_t *dst, uint16_t x, uint16_t y) {
+    for (uint16_t i = 0; i < w_; i += 4) {
+        uint8_t b = 0, n = (uint8_t)(w_ - i < 4 ? w_ - i : 4);
+        for (uint8_t k = 0; k < n; k++) {
+            int level = (gray[i + k] * 3 + offset(y, x + i + k)) / 255;
+            b |= (uint8_t)(gray_code[level] << (6 - 2 * k));
+        }
+        putBits(dst, 2u * (x + i), b, (uint8_t)(2 * n));
+    }
+}
+
+// Floyd-Steinberg in 1/16 pixel units. err_[1 + i] holds what the row
+// above left for pixel i; it is overwritten with the next row's share one
+// pixel behind the cursor, so a single row is enough. The 7/16 share to
+// the next pixel and the two not yet complete cells below ride in locals.
+void Ditherer::diffuse(const uint8_t *gray, uint8_t *dst, uint16_t x) {
+    int16_t *e = err_ + 1;            // e[-1] and e[w] are spill slots
+    const int dir = rtl_ ? -1 : 1;
+    const int levels = bpp_ == 2 ? 3 : 1;   // highest level
+    const int pixels_per_flush = 8 / bpp_;
+
+    int carry = 0, below = 0, below_next = 0;
+    uint8_t acc = 0, n = 0;
+    int i = rtl_ ? w_ - 1 : 0;
+    for (int k = 0; k < w_; k++, i += dir) {
+        int want = gray[i] * 16 + e[i] + carry;
+        int level = (want * levels + 8 * 255) / (16 * 255);   // nearest
+        if (level < 0) level = 0;
+        if (level > levels) level = levels;
+        int err = want - level * 16 * 255 / levels;
+
+        int d1 = err / 16, d3 = err * 3 / 16, d5 = err * 5 / 16;
+        carry = err - d1 - d3 - d5;   // 7/16 and the rounding
+        e[i - dir] = (int16_t)(below + d3);
+        below = below_next + d5;
+        below_next = d1;
+
+        uint8_t code = bpp_ == 2 ? gray_code[level] : (uint8_t)level;
+        if (rtl_) acc = (uint8_t)(acc >> bpp_ | code << (8 - bpp_));
+        else      acc = (uint8_t)(acc << bpp_ | code);
+        if (++n == pixels_per_flush || k == w_ - 1) {
+            // Left-most pixel of the group and the group at the top of acc
+            int left = rtl_ ? i : i - (n - 1);
+            uint8_t bits = rtl_ ? acc : (uint8_t)(acc << (8 - n * bpp_));
+            putBits(dst, (uint32_t)(x + left) * bpp_, bits, (uint8_t)(n * bpp_));
+            acc = 0;
+            n = 0;
+        }
+    }
+    e[i - dir] = (int16_t)below;   // i is one past the end: last pixel's own cell
+}
@@ -0,0 +1,44 @@
+#pragma once
+// Grayscale to 1 or 2 bpp on the device, one row at a time, written straight
+// into a packed surface row. Input is 8-bit, 0 = black, 255 = white.
+//
+//   DITHER_BAYER    8x8 ordered dither. Thresholds depend only on the pixel
+//                   position, so images sent in strips tile seamlessly; the
+//                   1 bpp path builds a whole output byte from 8 compares.
+//   DITHER_DIFFUSE  Floyd-Steinberg, serpentine, with one int16 error row
+//                   of width + 2 entries supplied by the caller. Errors do
+//                   not carry from one Ditherer to the next.
+//
+// 1 bpp output is framebuffer format (MSB = leftmost, 1 = white). 2 bpp is
+// EPD_4IN2_V2_Display_4Gray()'s: 4 pixels per byte, MSB first, codes
+// 00 black, 10 dark gray, 01 light gray, 11 white.
+
+#include <stddef.h>
+#include <stdint.h>
+
+enum DitherMode : uint8_t {
+    DITHER_BAYER   = 0,
+    DITHER_DIFFUSE = 1,
+};
+
+class Ditherer {
+public:
+    // `bpp` is 1 or 2; `err` (w + 2 values) is only used by DITHER_DIFFUSE
+    Ditherer(DitherMode mode, uint8_t bpp, uint16_t w, int16_t *err);
+
+    // `w` gray values into the surface row `dst`, starting at pixel `x`.
+    // `y` is the row's position on the surface: it picks the Bayer row, and
+    // the diffusion direction alternates with each call.
+    void row(const uint8_t *gray, uint8_t *dst, uint16_t x, uint16_t y);
+
+private:
+    void bayer1(const uint8_t *gray, uint8_t *dst, uint16_t x, uint16_t y);
+    void bayer2(const uint8_t *gray, uint8_t *dst, uint16_t x, uint16_t y);
+    void diffuse(const uint8_t *gray, uint8_t *dst, uint16_t x);
+
+    DitherMode mode_;
+    uint8_t    bpp_;
+    uint16_t   w_;
+    int16_t   *err_;
+    bool       rtl_ = false;   // serpentine: this row runs right to left
+};
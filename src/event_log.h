@@ -0,0 +1,47 @@
+#pragma once
+// Fixed-capacity ring of timestamped event lines for the EVENTS screen.
+// Adding copies the text into the oldest slot, so it is safe from the MQTT
+// callback; total() only ever grows, which lets the screen tell how many
+// lines arrived since it last drew.
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define EVENT_LOG_LINES 32   // kept in RAM; the screen shows the newest that fit
+#define EVENT_TEXT_MAX  26   // 25 characters + NUL, one Font16 row after the stamp
+
+struct EventLine {
+    uint32_t t_s;                    // uptime seconds when it happened
+    char     text[EVENT_TEXT_MAX];
+};
+
+class EventLog {
+public:
+    void add(uint32_t t_s, const char *text) {
+        EventLine &e = lines_[next_];
+        e.t_s = t_s;
+        size_t i = 0;
+        while (text && text[i] && i < EVENT_TEXT_MAX - 1) {
+            e.text[i] = text[i];
+            i++;
+        }
+        e.text[i] = '\0';
+        next_ = (next_ + 1) % EVENT_LOG_LINES;
+        if (count_ < EVENT_LOG_LINES) count_++;
+        total_++;
+    }
+
+    // 0 is the newest; `i` must be below count()
+    const EventLine &recent(uint16_t i) const {
+        return lines_[(next_ + EVENT_LOG_LINES - 1 - i) % EVENT_LOG_LINES];
+    }
+
+    uint16_t count() const { return count_; }
+    uint32_t total() const { return total_; }
+
+private:
+    EventLine lines_[EVENT_LOG_LINES] = {};
+    uint16_t  next_  = 0;
+    uint16_t  count_ = 0;
+    uint32_t  total_ = 0;
+};
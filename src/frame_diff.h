@@ -0,0 +1,64 @@
+#pragma once
+// Row-level change map between two surfaces of the same geometry, used to
+// skip pushing a frame the panel already shows and to narrow the rest to a
+// window. Compared four 32-bit words per step; only a word that differs is
+// looked at byte by byte, so an unchanged 15 KB frame costs one pass of
+// loads and XORs.
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#define FRAME_DIFF_MAX_ROWS 480   // tallest surface the firmware supports
+
+struct FrameDiff {
+    uint32_t rows[(FRAME_DIFF_MAX_ROWS + 31) / 32];   // bit y set: row y differs
+    uint16_t changed;                                 // rows that differ
+    uint16_t y0, y1;                                  // changed span; y0 == y1 when identical
+
+    bool row(uint16_t y) const { return rows[y >> 5] & (1u << (y & 31)); }
+};
+
+namespace frame_diff_detail {
+inline void mark(FrameDiff *d, size_t y) {
+    uint32_t bit = 1u << (y & 31);
+    if (d->rows[y >> 5] & bit) return;
+    d->rows[y >> 5] |= bit;
+    d->changed++;
+    if (d->y0 == d->y1 || y < d->y0) d->y0 = (uint16_t)y;
+    if (y + 1 > d->y1) d->y1 = (uint16_t)(y + 1);
+}
+
+// Bytes of one differing word; `x` is a ^ b in memory byte order
+inline void markWord(FrameDiff *d, size_t off, uint32_t x, uint16_t stride) {
+    uint8_t bytes[4];
+    memcpy(bytes, &x, 4);
+    for (int k = 0; k < 4; k++)
+        if (bytes[k]) mark(d, (off + k) / stride);
+}
+}  // namespace frame_diff_detail
+
+// `a` and `b` are 4-byte aligned, `stride * height` bytes each
+inline void frameDiff(const uint8_t *a, const uint8_t *b, uint16_t stride, uint16_t height,
+                      FrameDiff *out) {
+    using namespace frame_diff_detail;
+    memset(out, 0, sizeof(*out));
+    if (height > FRAME_DIFF_MAX_ROWS) height = FRAME_DIFF_MAX_ROWS;
+    const size_t len = (size_t)stride * height, words = len / 4;
+    const uint32_t *wa = (const uint32_t *)a, *wb = (const uint32_t *)b;
+
+    size_t i = 0;
+    for (; i + 4 <= words; i += 4) {
+        uint32_t x0 = wa[i] ^ wb[i], x1 = wa[i + 1] ^ wb[i + 1];
+        uint32_t x2 = wa[i + 2] ^ wb[i + 2], x3 = wa[i + 3] ^ wb[i + 3];
+        if (!(x0 | x1 | x2 | x3)) continue;
+        if (x0) markWord(out, 4 * i, x0, stride);
+        if (x1) markWord(out, 4 * (i + 1), x1, stride);
+        if (x2) markWord(out, 4 * (i + 2), x2, stride);
+        if (x3) markWord(out, 4 * (i + 3), x3, stride);
+    }
+    for (; i < words; i++)
+        if (uint32_t x = wa[i] ^ wb[i]) markWord(out, 4 * i, x, stride);
+    for (size_t off = 4 * words; off < len; off++)
+        if (a[off] != b[off]) mark(out, off / stride);
+}
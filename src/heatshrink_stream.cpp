@@ -0,0 +1,73 @@
+#include "heatshrink_stream.h"
+
+#include <string.h>
+
+void HeatshrinkStream::reset() {
+    state_    = TAG;
+    acc_      = 0;
+    acc_bits_ = 0;
+    index_    = 0;
+    head_     = 0;
+    out_len_  = 0;
+    produced_ = 0;
+    memset(window_, 0, sizeof(window_));
+}
+
+bool HeatshrinkStream::emit(uint8_t b) {
+    window_[head_] = b;
+    head_ = (head_ + 1) & (HS_WINDOW_SIZE - 1);
+    out_[out_len_++] = b;
+    produced_++;
+    if (out_len_ == HS_OUT_CHUNK) {
+        out_len_ = 0;
+        return sink_(out_, HS_OUT_CHUNK, ctx_);
+    }
+    return true;
+}
+
+bool HeatshrinkStream::takeBits(uint8_t n, uint16_t *out) {
+    if (acc_bits_ < n) return false;
+    acc_bits_ -= n;
+    *out = (uint16_t)((acc_ >> acc_bits_) & ((1u << n) - 1));
+    return true;
+}
+
+bool HeatshrinkStream::feed(const uint8_t *in, size_t len) {
+    for (size_t i = 0; i < len; i++) {
+        acc_ = (acc_ << 8) | in[i];
+        acc_bits_ += 8;
+
+        // Longest field is 10 bits, so the accumulator never holds more than 17
+        uint16_t v;
+        for (;;) {
+            if (state_ == TAG) {
+                if (!takeBits(1, &v)) break;
+                state_ = v ? LITERAL : INDEX;
+            } else if (state_ == LITERAL) {
+                if (!takeBits(8, &v)) break;
+                if (!emit((uint8_t)v)) return false;
+                state_ = TAG;
+            } else if (state_ == INDEX) {
+                if (!takeBits(HS_WINDOW_BITS, &v)) break;
+                index_ = v + 1;
+                state_ = COUNT;
+            } else {
+                if (!takeBits(HS_LOOKAHEAD_BITS, &v)) break;
+                for (uint16_t n = 0; n <= v; n++) {
+                    uint8_t b = window_[(head_ - index_) & (HS_WINDOW_SIZE - 1)];
+                    if (!emit(b)) return false;
+                }
+                state_ = TAG;
+            }
+        }
+    }
+    return true;
+}
+
+bool HeatshrinkStream::finish() {
+    // Trailing bits are zero padding from the encoder's last byte
+    if (out_len_ == 0) return true;
+    uint16_t n = out_len_;
+    out_len_ = 0;
+    return sink_(out_, n, ctx_);
+}
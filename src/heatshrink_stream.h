@@ -0,0 +1,49 @@
+#pragma once
+// Streaming decoder for heatshrink-compressed data (LZSS bitstream, MSB-first).
+// Compressed bytes go in as they arrive off the network; decompressed bytes
+// come out through a sink in chunks, so nothing ever holds the whole image.
+//
+// Token stream:  1 + 8 bits           literal byte
+//                0 + W bits + L bits  back-reference: offset - 1, count - 1
+// Must match the encoder's window / lookahead (heatshrink -w 10 -l 5,
+// or tools/ota_pack.py).
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define HS_WINDOW_BITS     10
+#define HS_LOOKAHEAD_BITS  5
+#define HS_WINDOW_SIZE     (1u << HS_WINDOW_BITS)
+#define HS_OUT_CHUNK       512
+
+class HeatshrinkStream {
+public:
+    // Returning false from the sink aborts decoding
+    typedef bool (*Sink)(const uint8_t *data, size_t len, void *ctx);
+
+    HeatshrinkStream(Sink sink, void *ctx) : sink_(sink), ctx_(ctx) { reset(); }
+
+    void reset();
+    bool feed(const uint8_t *in, size_t len);
+    bool finish();   // flushes buffered output
+
+    uint32_t produced() const { return produced_; }
+
+private:
+    enum State : uint8_t { TAG, LITERAL, INDEX, COUNT };
+
+    bool emit(uint8_t b);
+    bool takeBits(uint8_t n, uint16_t *out);
+
+    Sink     sink_;
+    void    *ctx_;
+    State    state_;
+    uint32_t acc_;
+    uint8_t  acc_bits_;
+    uint16_t index_;
+    uint16_t head_;
+    uint16_t out_len_;
+    uint32_t produced_;
+    uint8_t  window_[HS_WINDOW_SIZE];
+    uint8_t  out_[HS_OUT_CHUNK];
+};
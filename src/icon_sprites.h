@@ -0,0 +1,186 @@
+#pragma once
+// Auto-generated by tools/icon_sprites.py from tools/icon_sprites/icon_vectors.cpp
+// Pre-rasterized icons, blitted with Paint_DrawSprite. Do not edit; change the
+// vector source and regenerate.
+// Format: MSB-first, 1=WHITE 0=BLACK, rows padded to whole bytes
+
+#include <stdint.h>
+
+struct Sprite {
+    int8_t  dx, dy;         // top-left, relative to the vector helper's anchor
+    uint8_t w, h;
+    const unsigned char *bits;
+};
+
+// thermo: 7x17, 17 bytes
+static const unsigned char sprite_thermo[] PROGMEM = {
+    0x83, 0xBB, 0xBB, 0xBB, 0x83, 0x83, 0x83, 0x83, 0x83, 0x83, 0xC7, 0x83, 0x01, 0x01, 0x01, 0x83,
+    0xC7,
+};
+
+// drop: 9x15, 30 bytes
+static const unsigned char sprite_drop[] PROGMEM = {
+    0xF7, 0xFF, 0xEB, 0xFF, 0xEB, 0xFF, 0xDD, 0xFF, 0xDD, 0xFF, 0xBE, 0xFF, 0xA2, 0xFF, 0x1C, 0x7F,
+    0x3E, 0x7F, 0x7F, 0x7F, 0x7F, 0x7F, 0x7F, 0x7F, 0xBE, 0xFF, 0x9C, 0xFF, 0xE3, 0xFF,
+};
+
+// clock: 13x13, 26 bytes
+static const unsigned char sprite_clock[] PROGMEM = {
+    0xF0, 0x7F, 0xED, 0xBF, 0xDD, 0x9F, 0xBD, 0x6F, 0x7D, 0x77, 0x7C, 0xF7, 0x78, 0xF7, 0x7D, 0xF7,
+    0x7F, 0xF7, 0xBF, 0xEF, 0xDF, 0xDF, 0xEF, 0xBF, 0xF0, 0x7F,
+};
+
+// agent_on: 12x10, 20 bytes
+static const unsigned char sprite_agent_on[] PROGMEM = {
+    0xC0, 0x3F, 0xC0, 0x3F, 0x00, 0x0F, 0xC0, 0x3F, 0x0F, 0x0F, 0xCF, 0x3F, 0x00, 0x0F, 0xC0, 0x3F,
+    0x00, 0x0F, 0xC0, 0x3F,
+};
+
+// agent_off: 12x11, 22 bytes
+static const unsigned char sprite_agent_off[] PROGMEM = {
+    0xC0, 0x3F, 0xDF, 0xBF, 0x1F, 0x8F, 0xDF, 0xBF, 0x1B, 0x8F, 0xD1, 0xBF, 0x1B, 0x8F, 0xDF, 0xBF,
+    0x1F, 0x8F, 0xDF, 0xBF, 0xC0, 0x3F,
+};
+
+// home_on: 11x12, 24 bytes
+static const unsigned char sprite_home_on[] PROGMEM = {
+    0xFB, 0xFF, 0xF1, 0xFF, 0xE0, 0xFF, 0xC0, 0x7F, 0x80, 0x3F, 0x00, 0x1F, 0x00, 0x1F, 0x00, 0x1F,
+    0x1E, 0x1F, 0x1E, 0x1F, 0x1E, 0x1F, 0x00, 0x1F,
+};
+
+// home_off: 11x12, 24 bytes
+static const unsigned char sprite_home_off[] PROGMEM = {
+    0xFB, 0xFF, 0xF5, 0xFF, 0xEE, 0xFF, 0xDF, 0x7F, 0xBF, 0xBF, 0x00, 0x1F, 0x7F, 0xDF, 0x7F, 0xDF,
+    0x63, 0xDF, 0x6B, 0xDF, 0x6B, 0xDF, 0x00, 0x1F,
+};
+
+// gateway_on: 12x11, 22 bytes
+static const unsigned char sprite_gateway_on[] PROGMEM = {
+    0x7F, 0xEF, 0xBF, 0xDF, 0xDF, 0xBF, 0xDF, 0xBF, 0xEF, 0x7F, 0x00, 0x0F, 0x00, 0x0F, 0x00, 0x0F,
+    0x00, 0x0F, 0x09, 0x2F, 0x00, 0x0F,
+};
+
+// gateway_off: 12x12, 24 bytes
+static const unsigned char sprite_gateway_off[] PROGMEM = {
+    0x7F, 0xEF, 0xBF, 0xDF, 0xDF, 0xBF, 0xDF, 0xBF, 0xEF, 0x7F, 0x00, 0x0F, 0x7F, 0xEF, 0x7F, 0xEF,
+    0x7F, 0xEF, 0x76, 0xCF, 0x7F, 0xEF, 0x00, 0x0F,
+};
+
+// bars_0: 19x14, 42 bytes
+static const unsigned char sprite_bars_0[] PROGMEM = {
+    0xFF, 0xFE, 0x1F, 0xFF, 0xFE, 0xDF, 0xFF, 0xFE, 0xDF, 0xFF, 0xC2, 0xDF, 0xFF, 0xDA, 0xDF, 0xFF,
+    0xDA, 0xDF, 0xF8, 0x5A, 0xDF, 0xFB, 0x5A, 0xDF, 0xFB, 0x5A, 0xDF, 0x0B, 0x5A, 0xDF, 0x6B, 0x5A,
+    0xDF, 0x6B, 0x5A, 0xDF, 0x6B, 0x5A, 0xDF, 0x08, 0x42, 0x1F,
+};
+
+// bars_1: 19x14, 42 bytes
+static const unsigned char sprite_bars_1[] PROGMEM = {
+    0xFF, 0xFE, 0x1F, 0xFF, 0xFE, 0xDF, 0xFF, 0xFE, 0xDF, 0xFF, 0xC2, 0xDF, 0xFF, 0xDA, 0xDF, 0xFF,
+    0xDA, 0xDF, 0xF8, 0x5A, 0xDF, 0xFB, 0x5A, 0xDF, 0xFB, 0x5A, 0xDF, 0x0B, 0x5A, 0xDF, 0x0B, 0x5A,
+    0xDF, 0x0B, 0x5A, 0xDF, 0x0B, 0x5A, 0xDF, 0xF8, 0x42, 0x1F,
+};
+
+// bars_2: 19x14, 42 bytes
+static const unsigned char sprite_bars_2[] PROGMEM = {
+    0xFF, 0xFE, 0x1F, 0xFF, 0xFE, 0xDF, 0xFF, 0xFE, 0xDF, 0xFF, 0xC2, 0xDF, 0xFF, 0xDA, 0xDF, 0xFF,
+    0xDA, 0xDF, 0xF8, 0x5A, 0xDF, 0xF8, 0x5A, 0xDF, 0xF8, 0x5A, 0xDF, 0x08, 0x5A, 0xDF, 0x08, 0x5A,
+    0xDF, 0x08, 0x5A, 0xDF, 0x08, 0x5A, 0xDF, 0xFF, 0xC2, 0x1F,
+};
+
+// bars_3: 19x14, 42 bytes
+static const unsigned char sprite_bars_3[] PROGMEM = {
+    0xFF, 0xFE, 0x1F, 0xFF, 0xFE, 0xDF, 0xFF, 0xFE, 0xDF, 0xFF, 0xC2, 0xDF, 0xFF, 0xC2, 0xDF, 0xFF,
+    0xC2, 0xDF, 0xF8, 0x42, 0xDF, 0xF8, 0x42, 0xDF, 0xF8, 0x42, 0xDF, 0x08, 0x42, 0xDF, 0x08, 0x42,
+    0xDF, 0x08, 0x42, 0xDF, 0x08, 0x42, 0xDF, 0xFF, 0xFE, 0x1F,
+};
+
+// bars_4: 19x13, 39 bytes
+static const unsigned char sprite_bars_4[] PROGMEM = {
+    0xFF, 0xFE, 0x1F, 0xFF, 0xFE, 0x1F, 0xFF, 0xFE, 0x1F, 0xFF, 0xC2, 0x1F, 0xFF, 0xC2, 0x1F, 0xFF,
+    0xC2, 0x1F, 0xF8, 0x42, 0x1F, 0xF8, 0x42, 0x1F, 0xF8, 0x42, 0x1F, 0x08, 0x42, 0x1F, 0x08, 0x42,
+    0x1F, 0x08, 0x42, 0x1F, 0x08, 0x42, 0x1F,
+};
+
+// shield: 27x35, 140 bytes
+static const unsigned char sprite_shield[] PROGMEM = {
+    0x00, 0x00, 0x00, 0x1F, 0x00, 0x00, 0x00, 0x1F, 0x00, 0x00, 0x00, 0x1F, 0x00, 0x00, 0x00, 0x1F,
+    0x00, 0x00, 0x00, 0x1F, 0x00, 0x00, 0x00, 0x1F, 0x00, 0x00, 0x00, 0x1F, 0x00, 0x00, 0x00, 0x1F,
+    0x00, 0x00, 0x00, 0x1F, 0x00, 0x00, 0x00, 0x1F, 0x00, 0x00, 0x00, 0x1F, 0x00, 0x00, 0x00, 0x1F,
+    0x00, 0x00, 0x00, 0x1F, 0x00, 0x00, 0x00, 0x1F, 0x00, 0x00, 0x00, 0x1F, 0x00, 0x00, 0x00, 0x1F,
+    0x00, 0x00, 0x00, 0x1F, 0x00, 0x00, 0x00, 0x1F, 0x00, 0x00, 0x00, 0x1F, 0x00, 0x00, 0x00, 0x1F,
+    0x00, 0x00, 0x00, 0x1F, 0x00, 0x00, 0x00, 0x1F, 0x00, 0x00, 0x00, 0x1F, 0x00, 0x00, 0x00, 0x1F,
+    0x80, 0x00, 0x00, 0x3F, 0xC0, 0x00, 0x00, 0x7F, 0xE0, 0x00, 0x00, 0xFF, 0xF0, 0x00, 0x01, 0xFF,
+    0xF8, 0x00, 0x03, 0xFF, 0xFC, 0x00, 0x07, 0xFF, 0xFE, 0x00, 0x0F, 0xFF, 0xFF, 0x00, 0x1F, 0xFF,
+    0xFF, 0x80, 0x3F, 0xFF, 0xFF, 0xC0, 0x7F, 0xFF, 0xFF, 0xE0, 0xFF, 0xFF,
+};
+
+// shield_empty: 27x35, 140 bytes
+static const unsigned char sprite_shield_empty[] PROGMEM = {
+    0x00, 0x00, 0x00, 0x1F, 0x00, 0x00, 0x00, 0x1F, 0x00, 0x00, 0x00, 0x1F, 0x1F, 0xFF, 0xFF, 0x1F,
+    0x1F, 0xFF, 0xFF, 0x1F, 0x1F, 0xFF, 0xFF, 0x1F, 0x1F, 0xFF, 0xFF, 0x1F, 0x1F, 0xFF, 0xFF, 0x1F,
+    0x1F, 0xFF, 0xFF, 0x1F, 0x1F, 0xFF, 0xFF, 0x1F, 0x1F, 0xFF, 0xFF, 0x1F, 0x1F, 0xFF, 0xFF, 0x1F,
+    0x1F, 0xFF, 0xFF, 0x1F, 0x1F, 0xFF, 0xFF, 0x1F, 0x1F, 0xFF, 0xFF, 0x1F, 0x1F, 0xFF, 0xFF, 0x1F,
+    0x1F, 0xFF, 0xFF, 0x1F, 0x1F, 0xFF, 0xFF, 0x1F, 0x1F, 0xFF, 0xFF, 0x1F, 0x1F, 0xFF, 0xFF, 0x1F,
+    0x1F, 0xFF, 0xFF, 0x1F, 0x1F, 0xFF, 0xFF, 0x1F, 0x0F, 0xFF, 0xFE, 0x1F, 0x07, 0xFF, 0xFC, 0x1F,
+    0x83, 0xFF, 0xF8, 0x3F, 0xC1, 0xFF, 0xF0, 0x7F, 0xE0, 0xFF, 0xE0, 0xFF, 0xF0, 0x7F, 0xC1, 0xFF,
+    0xF8, 0x3F, 0x83, 0xFF, 0xFC, 0x1F, 0x07, 0xFF, 0xFE, 0x0E, 0x0F, 0xFF, 0xFF, 0x04, 0x1F, 0xFF,
+    0xFF, 0x80, 0x3F, 0xFF, 0xFF, 0xC0, 0x7F, 0xFF, 0xFF, 0xE0, 0xFF, 0xFF,
+};
+
+// warning: 43x33, 198 bytes
+static const unsigned char sprite_warning[] PROGMEM = {
+    0xFF, 0xFF, 0xF1, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xE0, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xE0, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xC0, 0x7F, 0xFF, 0xFF, 0xFF, 0xFF, 0x80, 0x3F, 0xFF, 0xFF, 0xFF, 0xFF,
+    0x84, 0x3F, 0xFF, 0xFF, 0xFF, 0xFF, 0x0E, 0x1F, 0xFF, 0xFF, 0xFF, 0xFE, 0x0E, 0x0F, 0xFF, 0xFF,
+    0xFF, 0xFE, 0x1F, 0x0F, 0xFF, 0xFF, 0xFF, 0xFC, 0x3F, 0x87, 0xFF, 0xFF, 0xFF, 0xF8, 0x31, 0x83,
+    0xFF, 0xFF, 0xFF, 0xF8, 0x71, 0xC3, 0xFF, 0xFF, 0xFF, 0xF0, 0xF1, 0xE1, 0xFF, 0xFF, 0xFF, 0xE0,
+    0xF1, 0xE0, 0xFF, 0xFF, 0xFF, 0xE1, 0xF1, 0xF0, 0xFF, 0xFF, 0xFF, 0xC3, 0xF1, 0xF8, 0x7F, 0xFF,
+    0xFF, 0x83, 0xF1, 0xF8, 0x3F, 0xFF, 0xFF, 0x87, 0xF1, 0xFC, 0x3F, 0xFF, 0xFF, 0x0F, 0xF1, 0xFE,
+    0x1F, 0xFF, 0xFE, 0x0F, 0xF1, 0xFE, 0x0F, 0xFF, 0xFE, 0x1F, 0xF1, 0xFF, 0x0F, 0xFF, 0xFC, 0x3F,
+    0xF1, 0xFF, 0x87, 0xFF, 0xF8, 0x3F, 0xF1, 0xFF, 0x83, 0xFF, 0xF8, 0x7F, 0xFF, 0xFF, 0xC3, 0xFF,
+    0xF0, 0xFF, 0xFF, 0xFF, 0xE1, 0xFF, 0xE0, 0xFF, 0xF1, 0xFF, 0xE0, 0xFF, 0xE1, 0xFF, 0xE0, 0xFF,
+    0xF0, 0xFF, 0xC3, 0xFF, 0xE0, 0xFF, 0xF8, 0x7F, 0x83, 0xFF, 0xE0, 0xFF, 0xF8, 0x3F, 0x87, 0xFF,
+    0xF1, 0xFF, 0xFC, 0x3F, 0x00, 0x00, 0x00, 0x00, 0x00, 0x1F, 0x00, 0x00, 0x00, 0x00, 0x00, 0x1F,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x1F,
+};
+
+enum SpriteId : uint8_t {
+    SPRITE_THERMO,
+    SPRITE_DROP,
+    SPRITE_CLOCK,
+    SPRITE_AGENT_ON,
+    SPRITE_AGENT_OFF,
+    SPRITE_HOME_ON,
+    SPRITE_HOME_OFF,
+    SPRITE_GATEWAY_ON,
+    SPRITE_GATEWAY_OFF,
+    SPRITE_BARS_0,
+    SPRITE_BARS_1,
+    SPRITE_BARS_2,
+    SPRITE_BARS_3,
+    SPRITE_BARS_4,
+    SPRITE_SHIELD,
+    SPRITE_SHIELD_EMPTY,
+    SPRITE_WARNING,
+    SPRITE_COUNT
+};
+
+static const Sprite sprites[SPRITE_COUNT] = {
+    {   1,  -1,  7, 17, sprite_thermo },
+    {   0,  -1,  9, 15, sprite_drop },
+    {   0,   0, 13, 13, sprite_clock },
+    {   1,   1, 12, 10, sprite_agent_on },
+    {   1,   1, 12, 11, sprite_agent_off },
+    {   1,   1, 11, 12, sprite_home_on },
+    {   1,   1, 11, 12, sprite_home_off },
+    {   1,   0, 12, 11, sprite_gateway_on },
+    {   1,   0, 12, 12, sprite_gateway_off },
+    {  -1,   0, 19, 14, sprite_bars_0 },
+    {  -1,   0, 19, 14, sprite_bars_1 },
+    {  -1,   0, 19, 14, sprite_bars_2 },
+    {  -1,   0, 19, 14, sprite_bars_3 },
+    {  -1,   0, 19, 13, sprite_bars_4 },
+    { -14, -18, 27, 35, sprite_shield },
+    { -14, -18, 27, 35, sprite_shield_empty },
+    { -22,  -2, 43, 33, sprite_warning },
+};
@@ -0,0 +1,58 @@
+#pragma once
+// Sliding window of latency samples with nearest-rank percentiles.
+// Adding is O(1); the sort only happens when a report is built, on a copy
+// in the caller's scratch, so recording stays cheap inside the MQTT callback.
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define LATENCY_WINDOW 64   // most recent samples kept per metric
+
+struct LatencySummary {
+    uint16_t n = 0;
+    uint32_t p50 = 0, p90 = 0, p99 = 0, max = 0;
+};
+
+class LatencyWindow {
+public:
+    void add(uint32_t v) {
+        samples_[next_] = v;
+        next_ = (next_ + 1) % LATENCY_WINDOW;
+        if (count_ < LATENCY_WINDOW) count_++;
+        total_++;
+    }
+
+    // `work` must hold LATENCY_WINDOW values
+    LatencySummary summarize(uint32_t *work) const {
+        LatencySummary s;
+        s.n = count_;
+        if (count_ == 0) return s;
+        for (uint16_t i = 0; i < count_; i++) {
+            uint32_t v = samples_[i];
+            int j = i;
+            while (j > 0 && work[j - 1] > v) {
+                work[j] = work[j - 1];
+                j--;
+            }
+            work[j] = v;
+        }
+        s.p50 = work[rank(50)];
+        s.p90 = work[rank(90)];
+        s.p99 = work[rank(99)];
+        s.max = work[count_ - 1];
+        return s;
+    }
+
+    uint32_t total() const { return total_; }
+
+private:
+    uint16_t rank(uint16_t pct) const {
+        uint16_t r = (uint16_t)((pct * count_ + 99) / 100);   // ceil(p * n)
+        return r ? r - 1 : 0;
+    }
+
+    uint32_t samples_[LATENCY_WINDOW] = {};
+    uint16_t next_  = 0;
+    uint16_t count_ = 0;
+    uint32_t total_ = 0;
+};
@@ -1,17 +1,37 @@
 #include <Arduino.h>
 #include <Wire.h>
 #include <WiFi.h>
+#include <Preferences.h>
 #include <PubSubClient.h>
 #include <SparkFun_SCD4x_Arduino_Library.h>
 
 #include <qrcode.h>
 
 #include <esp_task_wdt.h>
+#include <esp_wifi.h>
 
-#include "EPD_4in2.h"
 #include "GUI_Paint.h"
 #include "config.h"
+#include "config_store.h"
+#include "panel.h"
+#include "rotate.h"
 #include "hiki_bitmaps.h"
+#include "icon_sprites.h"
+#include "scratch_arena.h"
+#include "remote_frame.h"
+#include "display_list.h"
+#include "ota.h"
+#include "topics.h"
+#include "mqtt_qos.h"
+#include "status_server.h"
+#include "broker_discovery.h"
+#include "latency_stats.h"
+#include "event_log.h"
+#include "frame_diff.h"
+#include "text_format.h"
+#ifdef MQTT_TLS_CA_CERT
+#include "tls_client.h"
+#endif
 
 // I2C pins (ESP32-C6 Insight board)
 #define SDA_PIN 19
@@ -23,20 +43,61 @@
 #define BTN_DOWN      3
 #define DEBOUNCE_MS   50
 
-// Display
-#define DISPLAY_W EPD_4IN2_V2_WIDTH   // 400
-#define DISPLAY_H EPD_4IN2_V2_HEIGHT  // 300
+// Display: the drawing surface, from the panel and mounting selected at
+// build time (panel.h). The screens are laid out for landscape only, so a
+// DISPLAY_ROTATE build stops here until they have portrait layouts.
+#define DISPLAY_W SurfaceInfo::WIDTH    // 400 on the 4.2", 300 in portrait
+#define DISPLAY_H SurfaceInfo::HEIGHT   // 300, 400 in portrait
+static_assert(DISPLAY_W >= 400 && DISPLAY_H >= 300, "screens are laid out for at least 400x300");
+static_assert(DISPLAY_H <= FRAME_DIFF_MAX_ROWS, "frame diff row map too small for the surface");
+
+// ─── Static buffers / memory budget ───────────────────────────
+// Every long-lived buffer is sized at compile time and lives in .bss, so an
+// over-budget build fails to compile instead of booting without a display.
+
+#define QR_VERSION       6
+#define MQTT_BUFFER_SIZE 4096   // largest message; frame_encode.py bands key frames to fit
+#define MQTT_JSON_MAX    512
+#define SCRATCH_SIZE     2048   // per-frame / per-message transient buffers
+#define LINE_BUF         48     // one formatted line of text
+
+namespace MemBudget {
+    constexpr size_t FRAMEBUFFER = SurfaceInfo::FRAME_BYTES;                // 15000, 15200 in portrait
+    constexpr size_t QR_MODULES  = ((4 * QR_VERSION + 17) * (4 * QR_VERSION + 17) + 7) / 8; // 211
+    constexpr size_t MQTT_BUFFER = MQTT_BUFFER_SIZE;  // PubSubClient's own, allocated once in setup()
+    constexpr size_t SCRATCH     = SCRATCH_SIZE;
+    constexpr size_t OTA         = OTA_STATIC_RAM;  // decompressor window + network read, in ota.cpp
+    constexpr size_t TOPICS      = TOPIC_ARENA_SIZE; // interned topic strings, in topics.cpp
+    constexpr size_t STATUS_HTTP = sizeof(StatusServer); // request/response buffers
+    constexpr size_t LATENCY     = 3 * sizeof(LatencyWindow);
+    constexpr size_t EVENT_LOG   = sizeof(EventLog);
+    constexpr size_t ROTATE      = SurfaceInfo::PORTRAIT ? ROTATE_STATIC_RAM : 0;   // in rotate.cpp
+
+    constexpr size_t TOTAL  = 2 * FRAMEBUFFER + QR_MODULES + MQTT_BUFFER + SCRATCH + OTA + TOPICS +
+                              STATUS_HTTP + LATENCY + EVENT_LOG + ROTATE;
+    constexpr size_t LIMIT  = 64 * 1024;  // rest of SRAM is left to WiFi, lwIP and TLS
+}
+static_assert(MemBudget::TOTAL <= MemBudget::LIMIT, "static buffers exceed the RAM budget");
 
-static UBYTE *framebuffer = nullptr;
+// Two surfaces: the next screen is drawn into the back buffer while the
+// panel is still running the front one's waveform (see transitionTo())
+alignas(4) static UBYTE surfaces[2][MemBudget::FRAMEBUFFER];
+static UBYTE *framebuffer = surfaces[0];   // front: on the panel, or on its way there
+static UBYTE *backbuffer  = surfaces[1];
+static uint8_t qr_modules[MemBudget::QR_MODULES];
+alignas(4) static uint8_t scratch_mem[MemBudget::SCRATCH];
+static ScratchArena scratch(scratch_mem, sizeof(scratch_mem));
 
 // ─── Navigation ─────────────────────────────────────────────────
 
-enum Screen { HOME, ISOLATED, ISOLATED_HOME, DETAIL_BREATH, DETAIL_NERVE };
+enum Screen { HOME, ISOLATED, ISOLATED_HOME, DETAIL_BREATH, DETAIL_NERVE, EVENTS, REMOTE };
 
-#define DETAIL_TIMEOUT_MS   25000       // auto-return from detail screens
-#define SENSOR_INTERVAL_MS  120000      // read+publish sensors
-#define HOME_REFRESH_MS     60000       // re-render home with fresh data
-#define FULL_REFRESH_EVERY  5           // full e-ink waveform every N transitions
+// Sensor / refresh cadences are runtime settings, see config_store.h
+#define EPD_SLEEP_IDLE_MS   8000        // panel controller deep-sleeps after this much idle
+#define REMOTE_TIMEOUT_MS   300000      // gateway-pushed screen falls back to HOME
+#define REMOTE_PARTIALS_PER_FULL 10     // clear partial-refresh ghosting every N patches
+#define EVENT_PARTIALS_PER_CLEAN 10     // same for the event log window, every N scrolls
+#define DIFF_WINDOWS_PER_CLEAN   10     // same for same-screen redraws sent as a window
 
 // ─── State structs ────────────────────────────────────────────
 
@@ -74,6 +135,8 @@ struct NavState {
     unsigned long last_sensor       = 0;
     unsigned long last_home_refresh = 0;
     int           fast_count        = 0;
+    int           window_count      = 0;
+    bool          front_on_panel    = true;   // front buffer == panel RAM, so diffs against it hold
 };
 
 static SCD4x           scd4x_driver;
@@ -84,29 +147,63 @@ static GatewayHealth   gw_health;
 static NavState        nav;
 static bool            ks_changed = false;
 
+// Gateway-pushed frame currently on the panel (see remote_frame.h)
+struct RemoteFrameState {
+    bool     valid           = false;   // framebuffer == frame `seq` as the gateway knows it
+    uint16_t seq             = 0;
+    bool     dirty           = false;   // framebuffer ahead of the panel
+    bool     refresh_pending = false;   // last patch of a batch arrived
+    uint16_t x0 = 0, y0 = 0, x1 = 0, y1 = 0;   // dirty rect, end-exclusive
+    int      partials        = 0;
+};
+static RemoteFrameState remote;
+
+// Gateway message cost and killswitch-to-panel latency; reported on
+// <device>/telemetry/latency and /metrics, driven by tools/gateway_load.py
+struct LatencyState {
+    LatencyWindow handle_us;          // mqttCallback, gateway topics
+    LatencyWindow render_us;          // killswitch received -> framebuffer drawn
+    LatencyWindow refresh_ms;         // killswitch received -> panel refresh done
+    bool          ks_pending = false; // a killswitch message is not on the panel yet
+    unsigned long ks_rx_us   = 0;     // when the first such message arrived
+    unsigned long ks_rx_ms   = 0;
+    bool          ks_refreshing = false;   // its waveform is running
+    unsigned long refreshing_rx_ms = 0;
+    uint32_t      rx_gateway = 0, rx_dropped = 0;
+};
+static LatencyState lat;
+
+// Killswitch, node and CO2 transitions for the EVENTS screen
+struct EventView {
+    uint32_t shown    = 0;   // events.total() when the log window was last drawn
+    int      partials = 0;
+};
+static EventLog  events;
+static EventView event_view;
+
 // ─── Layout constants ─────────────────────────────────────────
 
 namespace Layout {
     constexpr int MARGIN_L   = 12;
-    constexpr int MARGIN_R   = 388;
+    constexpr int MARGIN_R   = DISPLAY_W - 12;   // 388
+    constexpr int CENTER_X   = DISPLAY_W / 2;
     constexpr int FONT16_W   = 11;
     constexpr int FONT20_W   = 14;
     constexpr int FONT24_W   = 17;
-    constexpr int CO2_MAX    = 2000;
     constexpr int RIGHT_COL  = 160;
 }
 
 // Network
-static WiFiClient wifiClient;
-static PubSubClient mqtt(wifiClient);
+#ifdef MQTT_TLS_CA_CERT
+static TlsClient netClient(MQTT_TLS_CA_CERT);   // resumes the TLS session on reconnect
+#else
+static WiFiClient netClient;
+#endif
+static MqttTap mqttTap(netClient);      // sees PUBACKs and inbound packet ids
+static PubSubClient mqtt(mqttTap);
+static QosOutbox outbox(mqttTap);       // QoS 1 sensor publishes
 
-// MQTT topics
-static const char * const TOPIC_CO2  = DEVICE_ID "/sensor/co2";
-static const char * const TOPIC_TEMP = DEVICE_ID "/sensor/temperature";
-static const char * const TOPIC_HUM  = DEVICE_ID "/sensor/humidity";
-static const char * const TOPIC_HEALTH = "hiki/health";
-static const char * const TOPIC_KILLSWITCH = "hiki/killswitch/status";
-static const char * const TOPIC_GW_HEALTH = "hiki/gateway/health";
+// MQTT topics are interned once at boot from config.device_id (topics.h)
 
 // ─── JSON helpers ──────────────────────────────────────────────
 
@@ -146,21 +243,137 @@ static bool jsonBool(const char *json, const char *key) {
     return strncmp(p, "true", 4) == 0;
 }
 
+// ─── Radio power policy ───────────────────────────────────────
+
+#define RADIO_ACTIVE_WINDOW_MS  30000   // low-latency radio after a button press / alert
+#define WIFI_LISTEN_INTERVAL    10      // beacon intervals between wakes in idle modem sleep
+#define MQTT_KEEPALIVE_IDLE_S   120     // negotiated at connect; must cover long modem sleep
+#define MQTT_KEEPALIVE_ACTIVE_S 30      // local ping cadence while someone is at the device
+
+enum RadioMode { RADIO_IDLE, RADIO_ACTIVE };
+
+struct RadioPolicy {
+    RadioMode     mode         = RADIO_ACTIVE;   // boot is interactive-ish
+    unsigned long active_until = RADIO_ACTIVE_WINDOW_MS;
+    unsigned long since        = 0;
+    unsigned long active_total = 0;
+    uint32_t      transitions  = 0;
+};
+
+static RadioPolicy radio;
+
+static void applyRadioMode() {
+    if (WiFi.status() != WL_CONNECTED) return;
+    if (radio.mode == RADIO_IDLE) {
+        // Listen interval is read by the power-save code when it enters
+        // max modem sleep, so set it before switching modes.
+        wifi_config_t conf;
+        if (esp_wifi_get_config(WIFI_IF_STA, &conf) == ESP_OK &&
+            conf.sta.listen_interval != WIFI_LISTEN_INTERVAL) {
+            conf.sta.listen_interval = WIFI_LISTEN_INTERVAL;
+            esp_wifi_set_config(WIFI_IF_STA, &conf);
+        }
+        WiFi.setSleep(WIFI_PS_MAX_MODEM);
+    } else {
+        WiFi.setSleep(WIFI_PS_NONE);
+    }
+    // Shortening keepalive locally only makes pings more frequent; the
+    // broker keeps the longer value negotiated at connect.
+    mqtt.setKeepAlive(radio.mode == RADIO_IDLE ? MQTT_KEEPALIVE_IDLE_S : MQTT_KEEPALIVE_ACTIVE_S);
+}
+
+static void publishRadioTelemetry(const char *reason) {
+    if (!mqtt.connected()) return;
+    ScratchScope scope(scratch);
+    char *buf = scratch.str(128);
+    if (!buf) return;
+    snprintf(buf, 128,
+             "{\"mode\":\"%s\",\"reason\":\"%s\",\"transitions\":%lu,\"active_ms\":%lu}",
+             radio.mode == RADIO_IDLE ? "idle" : "active", reason,
+             (unsigned long)radio.transitions, radio.active_total);
+    mqtt.publish(topic(TOPIC_RADIO), buf, true);
+}
+
+static void setRadioMode(RadioMode mode, const char *reason) {
+    unsigned long now = millis();
+    if (mode == radio.mode) return;
+    if (radio.mode == RADIO_ACTIVE) radio.active_total += now - radio.since;
+    radio.mode  = mode;
+    radio.since = now;
+    radio.transitions++;
+    applyRadioMode();
+    Serial.printf("RADIO: %s (%s)\n", mode == RADIO_IDLE ? "idle" : "active", reason);
+    publishRadioTelemetry(reason);
+}
+
+// Button press or alert: keep the radio responsive for a while
+static void radioActivity(const char *reason) {
+    radio.active_until = millis() + RADIO_ACTIVE_WINDOW_MS;
+    setRadioMode(RADIO_ACTIVE, reason);
+}
+
+static void radioTick(unsigned long now) {
+    if (radio.mode == RADIO_ACTIVE && (long)(now - radio.active_until) >= 0)
+        setRadioMode(RADIO_IDLE, "timeout");
+}
+
 // ─── MQTT ──────────────────────────────────────────────────────
 
+static void handleFramePatch(const uint8_t *data, unsigned int length);
+static void handleDrawList(const uint8_t *data, unsigned int length);
+static void handleOtaRequest(const char *json);
+static void handleOtaChunk(const uint8_t *data, unsigned int length);
+static void handleConfig(const char *json);
+
+static void logEvent(const char *text) {
+    events.add(millis() / 1000, text);
+    Serial.printf("EVENT: %s\n", text);
+}
+
+// Before the first message everything counts as up, so only downs are logged
+static void logNodeChange(const char *node, bool seen, bool was, bool now) {
+    if ((seen ? was : true) == now) return;
+    char line[EVENT_TEXT_MAX];
+    TextBuf(line, sizeof(line)).str(node).str(now ? " up" : " down");
+    logEvent(line);
+}
+
 static void mqttCallback(char *topic, byte *payload, unsigned int length) {
+    unsigned long rx_us = micros();
+    TopicId id = topicMatch(topic);
+    if (mqttTap.lastWasDuplicate()) {
+        Serial.printf("MQTT: duplicate id %u on %s dropped\n", mqttTap.lastPacketId(), topic);
+        return;
+    }
+
+    // Binary topics first: never printed or NUL-copied
+    switch (id) {
+        case TOPIC_FRAME:     handleFramePatch(payload, length); return;
+        case TOPIC_DRAW:      handleDrawList(payload, length);   return;
+        case TOPIC_OTA_CHUNK: handleOtaChunk(payload, length);   return;
+        default: break;
+    }
+
     Serial.printf("MQTT msg [%s]: %.*s\n", topic, length, (char *)payload);
 
-    if (length >= 512) {
+    if (length >= MQTT_JSON_MAX) {
         Serial.println("MQTT: message too large, dropped");
+        lat.rx_dropped++;
         return;
     }
 
-    char buf[512];
+    ScratchScope scope(scratch);
+    char *buf = scratch.str(length + 1);
+    if (!buf) {
+        Serial.println("MQTT: no scratch space, dropped");
+        lat.rx_dropped++;
+        return;
+    }
     memcpy(buf, payload, length);
     buf[length] = '\0';
 
-    if (strcmp(topic, TOPIC_HEALTH) == 0) {
+    if (id == TOPIC_HEALTH) {
+        bool seen = health.received, ha = health.ha, gw = health.gw, inet = health.inet;
         health.ha = jsonInt(buf, "ha") != 0;
         health.gw = jsonInt(buf, "gw") != 0;
         health.inet = jsonInt(buf, "inet") != 0;
@@ -174,8 +387,14 @@ static void mqttCallback(char *topic, byte *payload, unsigned int length) {
         jsonStr(buf, "up", health.up, sizeof(health.up));
         jsonStr(buf, "model", health.model, sizeof(health.model));
         health.received = true;
+        logNodeChange("HA", seen, ha, health.ha);
+        logNodeChange("Gateway", seen, gw, health.gw);
+        logNodeChange("Internet", seen, inet, health.inet);
         Serial.println("Health data parsed OK");
-    } else if (strcmp(topic, TOPIC_KILLSWITCH) == 0) {
+    } else if (id == TOPIC_KILLSWITCH) {
+        char prev[sizeof(killswitch.state)];
+        memcpy(prev, killswitch.state, sizeof(prev));
+        bool seen = killswitch.received;
         jsonStr(buf, "state", killswitch.state, sizeof(killswitch.state));
         jsonStr(buf, "address", killswitch.address, sizeof(killswitch.address));
         killswitch.ws_connected = jsonBool(buf, "ws_connected");
@@ -183,91 +402,160 @@ static void mqttCallback(char *topic, byte *payload, unsigned int length) {
         killswitch.block_number = jsonInt(buf, "block_number");
         killswitch.received = true;
         ks_changed = true;
+        if (!seen || strcmp(prev, killswitch.state) != 0) {
+            char line[EVENT_TEXT_MAX];
+            TextBuf ev(line, sizeof(line));
+            ev.str("KS ");
+            if (seen) ev.str(prev).str(" > ");
+            ev.str(killswitch.state);
+            logEvent(line);
+        }
+        // Messages that land while the panel is busy coalesce into one
+        // refresh; the oldest one is what the user waited for
+        if (!lat.ks_pending) {
+            lat.ks_pending = true;
+            lat.ks_rx_us = rx_us;
+            lat.ks_rx_ms = millis();
+        }
         Serial.printf("Killswitch: state=%s ws=%d addr=%s\n",
                        killswitch.state, killswitch.ws_connected, killswitch.address);
-    } else if (strcmp(topic, TOPIC_GW_HEALTH) == 0) {
+    } else if (id == TOPIC_GW_HEALTH) {
+        bool seen = gw_health.received, reachable = gw_health.ha_reachable;
         gw_health.ha_errors = jsonInt(buf, "ha_errors");
         gw_health.ha_reachable = jsonBool(buf, "ha_reachable");
         gw_health.received = true;
+        logNodeChange("GW->HA link", seen, reachable, gw_health.ha_reachable);
         Serial.printf("GW health: errors=%d reachable=%d\n",
                        gw_health.ha_errors, gw_health.ha_reachable);
+    } else if (id == TOPIC_OTA) {
+        handleOtaRequest(buf);
+    } else if (id == TOPIC_CONFIG) {
+        handleConfig(buf);
     }
-}
 
-static void publishSensorDiscovery(const char *name, const char *dev_class,
-                                   const char *suffix, const char *unit) {
-    char cfg[300], topic[80];
-    snprintf(cfg, sizeof(cfg),
-        "{\"name\":\"%s\","
-        "\"device_class\":\"%s\","
-        "\"state_topic\":\"" DEVICE_ID "/sensor/%s\","
-        "\"unit_of_measurement\":\"%s\","
-        "\"unique_id\":\"torii_ink_%s\","
-        "\"device\":{\"identifiers\":[\"torii_ink\"],"
-        "\"name\":\"Torii Ink\",\"model\":\"ESP32-C6 e-ink\","
-        "\"manufacturer\":\"Hiki\"}}",
-        name, dev_class, suffix, unit, suffix);
-    snprintf(topic, sizeof(topic),
-        "homeassistant/sensor/torii_ink_%s/config", suffix);
-    mqtt.publish(topic, cfg, true);
+    if (id == TOPIC_HEALTH || id == TOPIC_KILLSWITCH || id == TOPIC_GW_HEALTH) {
+        lat.rx_gateway++;
+        lat.handle_us.add(micros() - rx_us);
+    }
 }
 
 static void publishDiscovery() {
-    publishSensorDiscovery("CO2",         "carbon_dioxide", "co2",         "ppm");
-    publishSensorDiscovery("Temperature", "temperature",    "temperature", "\u00b0C");
-    publishSensorDiscovery("Humidity",    "humidity",       "humidity",    "%");
+    for (int i = 0; i < DISCOVERY_COUNT; i++) {
+        const Discovery &d = discovery(i);
+        mqtt.publish(topic(d.topic), d.payload, true);
+    }
     Serial.println("MQTT: HA discovery configs published");
 }
 
+// Anyone on the LAN can answer an mDNS browse, so discovered brokers are
+// only used when the TLS handshake can vouch for them
+static bool mdnsBrokers() {
+#ifdef MQTT_TLS_CA_CERT
+    return config.mqtt_mdns;
+#else
+    return false;
+#endif
+}
+
+// Configured server, or the discovered broker failover moved on to
+static void applyBrokerTarget() {
+    Broker b;
+    if (mdnsBrokers() && brokerSelected(&b)) {
+        mqtt.setServer(IPAddress(b.ip), b.port);
+        Serial.printf("MQTT: broker %s:%u (mDNS, %ums)\n",
+                      IPAddress(b.ip).toString().c_str(), b.port, b.rtt_ms);
+    } else {
+        mqtt.setServer(config.mqtt_server, (uint16_t)config.mqtt_port);
+    }
+}
+
 static void connectMQTT() {
     if (WiFi.status() != WL_CONNECTED) return;
     if (mqtt.connected()) return;
 
     Serial.print("MQTT: connecting... ");
-    if (mqtt.connect(DEVICE_ID)) {
-        Serial.println("connected");
-        mqtt.subscribe(TOPIC_HEALTH);
-        mqtt.subscribe(TOPIC_KILLSWITCH);
-        mqtt.subscribe(TOPIC_GW_HEALTH);
+    mqtt.setKeepAlive(MQTT_KEEPALIVE_IDLE_S);
+    // Persistent session: the broker queues QoS 1 state (killswitch!) while
+    // we're away and replays it here instead of us waiting for a retain
+    if (mqtt.connect(config.device_id, nullptr, nullptr, nullptr, 0, false, nullptr, false)) {
+        Serial.printf("connected (session %s)\n", mqttTap.sessionPresent() ? "resumed" : "new");
+        logEvent("MQTT connected");
+        brokerConnected();
+        applyRadioMode();
+        for (int i = 0; i < TOPIC_COUNT; i++) {
+            int qos = topicSubQos((TopicId)i);
+            if (qos >= 0) mqtt.subscribe(topic((TopicId)i), qos);
+        }
+        outbox.resendAll();
         for (int i = 0; i < 5; i++) { delay(100); mqtt.loop(); }
         publishDiscovery();
+        publishRadioTelemetry("connect");
+        otaConfirmBoot();   // WiFi + broker reachable: this image is good
     } else {
         Serial.printf("failed (rc=%d)\n", mqtt.state());
+        if (mdnsBrokers() && brokerFailed()) applyBrokerTarget();
     }
 }
 
+// QoS 1 through the outbox: queued while offline, newest value per topic wins
 static void publishSensors() {
-    if (!mqtt.connected()) return;
-
-    char val[16];
+    ScratchScope scope(scratch);
+    char *val = scratch.str(LINE_BUF);
+    if (!val) return;
     if (sensor.ok) {
-        snprintf(val, sizeof(val), "%.0f", sensor.co2);
-        mqtt.publish(TOPIC_CO2, val);
-        snprintf(val, sizeof(val), "%.1f", sensor.temp);
-        mqtt.publish(TOPIC_TEMP, val);
-        snprintf(val, sizeof(val), "%.0f", sensor.hum);
-        mqtt.publish(TOPIC_HUM, val);
+        TextBuf(val, LINE_BUF).fixed(sensor.co2, 0);
+        outbox.publish(topic(TOPIC_CO2), val, false);
+        TextBuf(val, LINE_BUF).fixed(sensor.temp, 1);
+        outbox.publish(topic(TOPIC_TEMP), val, false);
+        TextBuf(val, LINE_BUF).fixed(sensor.hum, 0);
+        outbox.publish(topic(TOPIC_HUM), val, false);
     }
-    Serial.println("MQTT: sensors published");
+    Serial.printf("MQTT: sensors queued (inflight=%u sent=%lu acked=%lu retries=%lu dropped=%lu dup_in=%lu)\n",
+                  outbox.inflight(), (unsigned long)outbox.sent(), (unsigned long)outbox.acks(),
+                  (unsigned long)outbox.retries(), (unsigned long)outbox.dropped(),
+                  (unsigned long)mqttTap.duplicates());
+}
+
+static int formatSummary(char *out, size_t sz, const char *name, const LatencySummary &s) {
+    return snprintf(out, sz, "\"%s\":{\"n\":%u,\"p50\":%lu,\"p90\":%lu,\"p99\":%lu,\"max\":%lu}",
+                    name, s.n, (unsigned long)s.p50, (unsigned long)s.p90,
+                    (unsigned long)s.p99, (unsigned long)s.max);
+}
+
+// `cause` is "flip" right after a killswitch refresh, "periodic" otherwise
+static void publishLatency(const char *cause) {
+    if (!mqtt.connected()) return;
+    const size_t sz = 384;
+    ScratchScope scope(scratch);
+    uint32_t *work = (uint32_t *)scratch.alloc(LATENCY_WINDOW * sizeof(uint32_t));
+    char *buf = scratch.str(sz);
+    if (!work || !buf) return;
+    int n = snprintf(buf, sz, "{\"cause\":\"%s\",\"rx\":%lu,\"dropped\":%lu,", cause,
+                     (unsigned long)lat.rx_gateway, (unsigned long)lat.rx_dropped);
+    n += formatSummary(buf + n, sz - n, "handle_us", lat.handle_us.summarize(work));
+    n += snprintf(buf + n, sz - n, ",");
+    n += formatSummary(buf + n, sz - n, "render_us", lat.render_us.summarize(work));
+    n += snprintf(buf + n, sz - n, ",");
+    n += formatSummary(buf + n, sz - n, "refresh_ms", lat.refresh_ms.summarize(work));
+    snprintf(buf + n, sz - n, "}");
+    mqtt.publish(topic(TOPIC_LATENCY), buf);
 }
 
 // ─── Hardware init ─────────────────────────────────────────────
 
 static void initDisplay() {
     DEV_Module_Init();
-    EPD_4IN2_V2_Init();
-    EPD_4IN2_V2_Clear();
-    EPD_4IN2_V2_Init_Fast(Seconds_1_5S);
-
-    uint32_t imageSize = ((DISPLAY_W % 8 == 0) ? (DISPLAY_W / 8) : (DISPLAY_W / 8 + 1)) * DISPLAY_H;
-    framebuffer = (UBYTE *)malloc(imageSize);
-    if (!framebuffer) {
-        Serial.println("Failed to allocate framebuffer!");
-        return;
-    }
+    Panel::init();
+    Panel::clear();
+    if (SurfaceInfo::PORTRAIT)
+        Panel::setRowSource(rotateRow);   // surface turned into panel order as it is pushed
+    Serial.printf("EPD: %s panel, %ux%u surface\n", Panel::NAME, (unsigned)DISPLAY_W, (unsigned)DISPLAY_H);
+
     Paint_NewImage(framebuffer, DISPLAY_W, DISPLAY_H, ROTATE_0, WHITE);
     Paint_SelectImage(framebuffer);
     Paint_Clear(WHITE);
+    memcpy(backbuffer, framebuffer, MemBudget::FRAMEBUFFER);
+    Panel::setAsync(true);   // refreshes run while loop() carries on
 }
 
 static void initSensors() {
@@ -281,24 +569,146 @@ static void initSensors() {
     }
 }
 
-static void initWiFi() {
-    Serial.printf("WiFi: connecting to %s", WIFI_SSID);
-    WiFi.mode(WIFI_STA);
-    WiFi.begin(WIFI_SSID, WIFI_PASSWORD);
+// ─── WiFi fast reconnect ──────────────────────────────────────
+
+#define WIFI_FAST_TIMEOUT_MS  4000      // directed join + DHCP budget before falling back to a scan
+#define WIFI_FULL_TIMEOUT_MS  10000
+#define WIFI_CACHE_MAGIC      0x57434132  // "WCA2"
+
+// Last good association, persisted in NVS so reboots skip the scan too.
+// The address always comes from DHCP (or WIFI_STATIC_IP): a lease replayed
+// as a static config is never renewed, and the server may hand it out again.
+struct WiFiCache {
+    uint32_t magic   = 0;
+    uint8_t  bssid[6] = {};
+    int32_t  channel = 0;
+};
+
+static WiFiCache wifi_cache;
+
+static bool wifiCacheValid() {
+    return wifi_cache.magic == WIFI_CACHE_MAGIC && wifi_cache.channel > 0;
+}
+
+static void loadWiFiCache() {
+    Preferences prefs;
+    if (!prefs.begin("wifi", true)) return;
+    if (prefs.getBytesLength("assoc") == sizeof(WiFiCache))
+        prefs.getBytes("assoc", &wifi_cache, sizeof(WiFiCache));
+    prefs.end();
+    if (!wifiCacheValid()) wifi_cache = WiFiCache();
+}
+
+// Only writes when something changed, to keep NVS wear down
+static void saveWiFiCache() {
+    WiFiCache fresh;
+    fresh.magic   = WIFI_CACHE_MAGIC;
+    memcpy(fresh.bssid, WiFi.BSSID(), sizeof(fresh.bssid));
+    fresh.channel = WiFi.channel();
+    if (memcmp(&fresh, &wifi_cache, sizeof(WiFiCache)) == 0) return;
+
+    wifi_cache = fresh;
+    Preferences prefs;
+    if (!prefs.begin("wifi", false)) return;
+    prefs.putBytes("assoc", &wifi_cache, sizeof(WiFiCache));
+    prefs.end();
+    Serial.printf("WiFi: cached bssid/ch%d\n", (int)wifi_cache.channel);
+}
 
-    int attempts = 0;
-    while (WiFi.status() != WL_CONNECTED && attempts < 20) {
-        delay(500);
-        Serial.print(".");
-        attempts++;
+static void clearWiFiCache() {
+    wifi_cache = WiFiCache();
+    Preferences prefs;
+    if (!prefs.begin("wifi", false)) return;
+    prefs.remove("assoc");
+    prefs.end();
+}
+
+// Static IP from config.h wins; otherwise DHCP, on the fast path too
+static void applyIPConfig() {
+#ifdef WIFI_STATIC_IP
+    IPAddress ip, gw, mask, dns;
+    ip.fromString(WIFI_STATIC_IP);
+    gw.fromString(WIFI_STATIC_GATEWAY);
+    mask.fromString(WIFI_STATIC_MASK);
+    dns.fromString(WIFI_STATIC_DNS);
+    WiFi.config(ip, gw, mask, dns);
+#else
+    WiFi.config(INADDR_NONE, INADDR_NONE, INADDR_NONE, INADDR_NONE);
+#endif
+}
+
+static bool waitWiFi(unsigned long timeout_ms) {
+    unsigned long start = millis();
+    while (WiFi.status() != WL_CONNECTED) {
+        if (millis() - start >= timeout_ms) return false;
+        delay(10);
+        esp_task_wdt_reset();
     }
-    Serial.println();
+    return true;
+}
 
-    if (WiFi.status() == WL_CONNECTED) {
-        Serial.printf("WiFi: connected, IP=%s\n", WiFi.localIP().toString().c_str());
-    } else {
+// Directed join on the cached BSSID/channel first (no scan), full scan
+// only when that fails.
+//
+// waitWiFi() returns once the interface has an address, so the fast path
+// still includes a DHCP exchange and keeps the lease current.
+static bool connectWiFi() {
+    unsigned long start = millis();
+    WiFi.disconnect();
+
+    applyIPConfig();
+    if (wifiCacheValid()) {
+        WiFi.begin(config.wifi_ssid, config.wifi_pass, wifi_cache.channel, wifi_cache.bssid);
+        if (waitWiFi(WIFI_FAST_TIMEOUT_MS)) {
+            Serial.printf("WiFi: connected in %lums (fast), IP=%s\n",
+                          millis() - start, WiFi.localIP().toString().c_str());
+            saveWiFiCache();
+            applyRadioMode();
+            return true;
+        }
+        Serial.println("WiFi: directed join failed, rescanning");
+        clearWiFiCache();
+        WiFi.disconnect();
+    }
+
+    WiFi.begin(config.wifi_ssid, config.wifi_pass);
+    if (!waitWiFi(WIFI_FULL_TIMEOUT_MS)) {
         Serial.println("WiFi: connection failed, will retry");
+        return false;
     }
+    Serial.printf("WiFi: connected in %lums (scan), IP=%s\n",
+                  millis() - start, WiFi.localIP().toString().c_str());
+    saveWiFiCache();
+    applyRadioMode();
+    return true;
+}
+
+static void initWiFi() {
+    Serial.printf("WiFi: connecting to %s\n", config.wifi_ssid);
+    WiFi.persistent(false);  // we keep our own cache; skip the driver's NVS writes
+    WiFi.mode(WIFI_STA);
+    loadWiFiCache();
+    connectWiFi();
+}
+
+// CO2 crossing 1000 / 1500 ppm goes in the event log; a reading has to
+// drop CO2_EVENT_HYST below a threshold to cross it back down, so a room
+// hovering at 1000 does not fill the log
+#define CO2_EVENT_HYST 50
+
+static void logCO2Crossing() {
+    static const int   limits[] = { 1000, 1500 };
+    static const char *names[]  = { "ok", "stuffy", "ventilate" };
+    static int band = 0;
+    int co2 = (int)sensor.co2;
+    int next = band;
+    while (next < 2 && co2 > limits[next]) next++;
+    while (next > 0 && co2 < limits[next - 1] - CO2_EVENT_HYST) next--;
+    if (next == band) return;
+    band = next;
+    char line[EVENT_TEXT_MAX];
+    TextBuf(line, sizeof(line)).str("CO2 ").num(co2).str(" ppm ").str(names[band]);
+    logEvent(line);
 }
 
 static bool readSCD4x() {
@@ -309,6 +719,7 @@ static bool readSCD4x() {
         sensor.temp = scd4x_driver.getTemperature();
         sensor.hum = scd4x_driver.getHumidity();
         Serial.printf("SCD4x: CO2=%.0f ppm, T=%.1f C, H=%.0f%%\n", sensor.co2, sensor.temp, sensor.hum);
+        logCO2Crossing();
         return true;
     }
     return false;
@@ -326,7 +737,7 @@ static bool isIsolated() {
 
 static int clampedCO2() {
     int v = (int)sensor.co2;
-    return (v > Layout::CO2_MAX) ? Layout::CO2_MAX : v;
+    return (v > (int)config.co2_max) ? (int)config.co2_max : v;
 }
 
 static const char *getCO2Label() {
@@ -355,6 +766,21 @@ static const char *getPersonalityMessage() {
 
 // ─── Drawing helpers ───────────────────────────────────────────
 
+// Window refresh of part of the front buffer, given in surface coordinates
+static void showSurfaceWindow(uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1, PanelWave wave) {
+    PanelRect r = rotateRect(x0, y0, x1, y1);
+    Panel::showWindow(framebuffer, r.x0, r.y0, r.x1, r.y1, wave);
+}
+
+// The periodic clean after a run of window refreshes: the cleaning waveform
+// over the window where the panel has uploaded LUTs, else a fast full refresh
+static void showSurfaceClean(uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1) {
+    if (PanelInfo::has(PANEL_CAP_LUT))
+        showSurfaceWindow(x0, y0, x1, y1, PANEL_WAVE_CLEAN);
+    else
+        Panel::showFast(framebuffer);
+}
+
 // Corner brackets on 4 corners of display
 static void drawCornerBrackets(int arm = 15, int margin = 2) {
     // Top-left
@@ -373,8 +799,9 @@ static void drawCornerBrackets(int arm = 15, int margin = 2) {
 
 // Cyber header: ">> LABEL <<" + solid line below
 static void drawCyberHeader(int y, const char *label) {
-    char buf[40];
-    snprintf(buf, sizeof(buf), ">> %s <<", label);
+    char *buf = scratch.str(LINE_BUF);
+    if (!buf) return;
+    TextBuf(buf, LINE_BUF).str(">> ").str(label).str(" <<");
     Paint_DrawString_EN(Layout::MARGIN_L, y, buf, &Font20, WHITE, BLACK);
     Paint_DrawLine(Layout::MARGIN_L, y + 22, Layout::MARGIN_R, y + 22, BLACK, DOT_PIXEL_1X1, LINE_STYLE_SOLID);
 }
@@ -386,7 +813,7 @@ static void drawDottedLine(int y) {
 }
 
 // Double horizontal line
-static void drawDoubleLine(int y, int x1 = 8, int x2 = 392) {
+static void drawDoubleLine(int y, int x1 = 8, int x2 = DISPLAY_W - 8) {
     Paint_DrawLine(x1, y, x2, y, BLACK, DOT_PIXEL_1X1, LINE_STYLE_SOLID);
     Paint_DrawLine(x1, y + 3, x2, y + 3, BLACK, DOT_PIXEL_1X1, LINE_STYLE_SOLID);
 }
@@ -398,11 +825,12 @@ static void drawAddress(int x, int y, const char *addr, sFONT *font) {
         return;
     }
     int len = strlen(addr);
-    char short_addr[20];
+    char *short_addr = scratch.str(LINE_BUF);
+    if (!short_addr) return;
     if (len > 12) {
-        snprintf(short_addr, sizeof(short_addr), "%.8s...%.4s", addr, addr + len - 4);
+        TextBuf(short_addr, LINE_BUF).str(addr, 8).str("...").str(addr + len - 4);
     } else {
-        snprintf(short_addr, sizeof(short_addr), "%s", addr);
+        TextBuf(short_addr, LINE_BUF).str(addr);
     }
     Paint_DrawString_EN(x, y, short_addr, font, WHITE, BLACK);
 }
@@ -427,94 +855,35 @@ static void drawProgressBar(int x, int y, int w, int h, int value, int max_value
 
 // ─── Icon helpers ─────────────────────────────────────────────
 
-static void drawIconThermo(int x, int y) {
-    Paint_DrawRectangle(x + 3, y, x + 7, y + 9, BLACK, DOT_PIXEL_1X1, DRAW_FILL_EMPTY);
-    Paint_DrawRectangle(x + 4, y + 4, x + 6, y + 9, BLACK, DOT_PIXEL_1X1, DRAW_FILL_FULL);
-    Paint_DrawCircle(x + 5, y + 13, 3, BLACK, DOT_PIXEL_1X1, DRAW_FILL_FULL);
+// Pre-rasterized from tools/icon_sprites/icon_vectors.cpp by
+// tools/icon_sprites.py; x/y is the anchor the vector helper took.
+static void drawSprite(SpriteId id, int x, int y) {
+    const Sprite &s = sprites[id];
+    Paint_DrawSprite(s.bits, x + s.dx, y + s.dy, s.w, s.h);
 }
 
-static void drawIconDrop(int x, int y) {
-    Paint_DrawLine(x + 5, y, x + 1, y + 8, BLACK, DOT_PIXEL_1X1, LINE_STYLE_SOLID);
-    Paint_DrawLine(x + 5, y, x + 9, y + 8, BLACK, DOT_PIXEL_1X1, LINE_STYLE_SOLID);
-    Paint_DrawCircle(x + 5, y + 10, 4, BLACK, DOT_PIXEL_1X1, DRAW_FILL_EMPTY);
-}
-
-static void drawIconClock(int x, int y) {
-    int cx = x + 7, cy = y + 7;
-    Paint_DrawCircle(cx, cy, 6, BLACK, DOT_PIXEL_1X1, DRAW_FILL_EMPTY);
-    Paint_DrawLine(cx, cy, cx + 3, cy - 4, BLACK, DOT_PIXEL_1X1, LINE_STYLE_SOLID);
-    Paint_DrawLine(cx, cy, cx, cy - 5, BLACK, DOT_PIXEL_1X1, LINE_STYLE_SOLID);
-    Paint_DrawCircle(cx, cy, 1, BLACK, DOT_PIXEL_1X1, DRAW_FILL_FULL);
-}
+static void drawIconThermo(int x, int y) { drawSprite(SPRITE_THERMO, x, y); }
+static void drawIconDrop(int x, int y)   { drawSprite(SPRITE_DROP, x, y); }
+static void drawIconClock(int x, int y)  { drawSprite(SPRITE_CLOCK, x, y); }
 
 // Chip icon for AI Agent (16×16)
 static void drawIconAgent(int x, int y, bool online) {
-    // Chip body
-    Paint_DrawRectangle(x+4, y+2, x+11, y+12, BLACK, DOT_PIXEL_1X1,
-                        online ? DRAW_FILL_FULL : DRAW_FILL_EMPTY);
-    // Side pins (4 pairs)
-    for (int i = 0; i < 4; i++) {
-        int py = y + 4 + i * 2;
-        Paint_DrawLine(x+2, py, x+4, py, BLACK, DOT_PIXEL_1X1, LINE_STYLE_SOLID);
-        Paint_DrawLine(x+11, py, x+13, py, BLACK, DOT_PIXEL_1X1, LINE_STYLE_SOLID);
-    }
-    // Core
-    if (online)
-        Paint_DrawRectangle(x+6, y+6, x+9, y+8, WHITE, DOT_PIXEL_1X1, DRAW_FILL_FULL);
-    else
-        Paint_DrawCircle(x+7, y+7, 1, BLACK, DOT_PIXEL_1X1, DRAW_FILL_FULL);
+    drawSprite(online ? SPRITE_AGENT_ON : SPRITE_AGENT_OFF, x, y);
 }
 
 // House icon for Smart Home (16×16)
 static void drawIconHome(int x, int y, bool online) {
-    int peak_x = x + 7, peak_y = y + 2;
-    int roof_l = x + 2, roof_r = x + 12, roof_base = y + 7;
-    // Roof lines
-    Paint_DrawLine(peak_x, peak_y, roof_l, roof_base, BLACK, DOT_PIXEL_1X1, LINE_STYLE_SOLID);
-    Paint_DrawLine(peak_x, peak_y, roof_r, roof_base, BLACK, DOT_PIXEL_1X1, LINE_STYLE_SOLID);
-    // Walls
-    Paint_DrawRectangle(roof_l, roof_base, roof_r, y+13, BLACK, DOT_PIXEL_1X1, DRAW_FILL_EMPTY);
-    if (online) {
-        // Fill roof
-        for (int row = peak_y + 1; row < roof_base; row++) {
-            int half_w = row - peak_y;
-            Paint_DrawLine(peak_x - half_w, row, peak_x + half_w, row,
-                           BLACK, DOT_PIXEL_1X1, LINE_STYLE_SOLID);
-        }
-        // Fill walls
-        Paint_DrawRectangle(roof_l, roof_base, roof_r, y+13, BLACK, DOT_PIXEL_1X1, DRAW_FILL_FULL);
-        // Door cutout
-        Paint_DrawRectangle(x+5, y+10, x+8, y+13, WHITE, DOT_PIXEL_1X1, DRAW_FILL_FULL);
-    } else {
-        // Door outline
-        Paint_DrawRectangle(x+5, y+10, x+7, y+13, BLACK, DOT_PIXEL_1X1, DRAW_FILL_EMPTY);
-    }
+    drawSprite(online ? SPRITE_HOME_ON : SPRITE_HOME_OFF, x, y);
 }
 
 // Router icon for Gateway (16×16)
 static void drawIconGateway(int x, int y, bool online) {
-    // Device body
-    Paint_DrawRectangle(x+2, y+6, x+13, y+12, BLACK, DOT_PIXEL_1X1,
-                        online ? DRAW_FILL_FULL : DRAW_FILL_EMPTY);
-    // Antennas
-    Paint_DrawLine(x+6, y+6, x+2, y+1, BLACK, DOT_PIXEL_1X1, LINE_STYLE_SOLID);
-    Paint_DrawLine(x+9, y+6, x+13, y+1, BLACK, DOT_PIXEL_1X1, LINE_STYLE_SOLID);
-    // LED indicators
-    UWORD led_color = online ? WHITE : BLACK;
-    Paint_SetPixel(x+5, y+9, led_color);
-    Paint_SetPixel(x+8, y+9, led_color);
-    Paint_SetPixel(x+11, y+9, led_color);
+    drawSprite(online ? SPRITE_GATEWAY_ON : SPRITE_GATEWAY_OFF, x, y);
 }
 
 static void drawSignalBars(int x, int y, int rssi) {
     int bars = (rssi > -50) ? 4 : (rssi > -60) ? 3 : (rssi > -70) ? 2 : (rssi > -80) ? 1 : 0;
-    for (int i = 0; i < 4; i++) {
-        int bx = x + i * 5;
-        int bh = 4 + i * 3;
-        int by = y + 14 - bh;
-        Paint_DrawRectangle(bx, by, bx + 3, y + 14, BLACK, DOT_PIXEL_1X1,
-                            (i < bars) ? DRAW_FILL_FULL : DRAW_FILL_EMPTY);
-    }
+    drawSprite((SpriteId)(SPRITE_BARS_0 + bars), x, y);
 }
 
 // Inverted badge: black background, white text
@@ -523,23 +892,29 @@ static void drawBadge(int x, int y, const char *text, sFONT *font) {
     int h = font->Height + 2;
     if (x + w > DISPLAY_W) w = DISPLAY_W - x;
     Paint_DrawRectangle(x, y, x + w, y + h, BLACK, DOT_PIXEL_1X1, DRAW_FILL_FULL);
+    // Long text is cut at the badge edge instead of running off it; the
+    // 1px pen puts the box one pixel up/left of its corners
+    Paint_PushClip(x > 0 ? x - 1 : 0, y > 0 ? y - 1 : 0, x + w, y + h - 1);
     Paint_DrawString_EN(x + 4, y + 1, text, font, BLACK, WHITE);
+    Paint_PopClip();
 }
 
 static void drawWiFiStatus(int x, int y) {
     int rssi = WiFi.RSSI();
-    char buf[12];
-    snprintf(buf, sizeof(buf), "%ddB", rssi);
+    char *buf = scratch.str(LINE_BUF);
+    if (!buf) return;
+    TextBuf(buf, LINE_BUF).num(rssi).str("dB");
     drawSignalBars(x, y, rssi);
     Paint_DrawString_EN(x + 22, y + 2, buf, &Font16, WHITE, BLACK);
 }
 
 static void drawNodeStatusLine(int x, int y) {
-    char buf[48];
+    char *buf = scratch.str(LINE_BUF);
+    if (!buf) return;
     const char *ha_s  = health.received ? (health.ha  ? "ok" : "!") : "--";
     const char *gw_s  = health.received ? (health.gw  ? "ok" : "!") : "--";
     const char *net_s = health.received ? (health.inet ? "ok" : "!") : "--";
-    snprintf(buf, sizeof(buf), "HA:%s  GW:%s  NET:%s", ha_s, gw_s, net_s);
+    TextBuf(buf, LINE_BUF).str("HA:").str(ha_s).str("  GW:").str(gw_s).str("  NET:").str(net_s);
     Paint_DrawString_EN(x, y, buf, &Font16, WHITE, BLACK);
 }
 
@@ -551,8 +926,11 @@ static void drawLabeledPanel(int x, int y, int w, int h,
     int lbl_w = strlen(label) * Layout::FONT16_W + 4;
     Paint_DrawRectangle(x + 4, y - 2, x + lbl_w, y + 2, WHITE, DOT_PIXEL_1X1, DRAW_FILL_FULL);
     Paint_DrawString_EN(x + 6, y - 7, label, &Font16, WHITE, BLACK);
+    // Icon and value stay inside the border (drawn one pixel up/left)
+    Paint_PushClip(x, y, x + w - 1, y + h - 1);
     if (icon) icon(x + 10, y + 10);
     Paint_DrawString_EN(x + 28, y + 12, value, &Font20, WHITE, BLACK);
+    Paint_PopClip();
 }
 
 // Speech bubble with pointer toward mascot
@@ -566,8 +944,9 @@ static void drawSpeechBubble(int x, int y, int w, int h) {
 
 static void drawBlockNumber(int x, int y, sFONT *font) {
     if (killswitch.block_number <= 0) return;
-    char buf[32];
-    snprintf(buf, sizeof(buf), "Block: #%d", killswitch.block_number);
+    char *buf = scratch.str(LINE_BUF);
+    if (!buf) return;
+    TextBuf(buf, LINE_BUF).str("Block: #").num(killswitch.block_number);
     Paint_DrawString_EN(x, y, buf, font, WHITE, BLACK);
 }
 
@@ -575,8 +954,7 @@ static void drawBlockNumber(int x, int y, sFONT *font) {
 static void drawQR(int qr_x, int qr_y, int px_sz) {
     if (!killswitch.address[0]) return;
     QRCode qrcode;
-    uint8_t qrcodeData[qrcode_getBufferSize(6)];
-    qrcode_initText(&qrcode, qrcodeData, 6, ECC_LOW, killswitch.address);
+    qrcode_initText(&qrcode, qr_modules, QR_VERSION, ECC_LOW, killswitch.address);
     int qr_size = qrcode.size;
     int qr_px = qr_size * px_sz;
     Paint_DrawRectangle(qr_x - 2, qr_y - 2, qr_x + qr_px + 2, qr_y + qr_px + 2,
@@ -592,7 +970,8 @@ static void drawQR(int qr_x, int qr_y, int px_sz) {
 // ─── Screen: HOME ──────────────────────────────────────────────
 
 static void renderHomePage() {
-    char buf[48];
+    char *buf = scratch.str(LINE_BUF);
+    if (!buf) return;
     int rx = Layout::RIGHT_COL;  // 160
 
     // ── Left column: Mascot ──
@@ -629,7 +1008,7 @@ static void renderHomePage() {
     // Temperature (Font24, prominent)
     if (sensor.ok) {
         drawIconThermo(12, 205);
-        snprintf(buf, sizeof(buf), "%.1f C", sensor.temp);
+        TextBuf(buf, LINE_BUF).fixed(sensor.temp, 1).str(" C");
         Paint_DrawString_EN(30, 205, buf, &Font24, WHITE, BLACK);
     } else {
         Paint_DrawString_EN(12, 205, "Temp: --", &Font24, WHITE, BLACK);
@@ -642,23 +1021,22 @@ static void renderHomePage() {
     bool gw_ok    = health.received && health.gw;
 
     drawIconAgent(12, iy, agent_ok);
-    snprintf(buf, sizeof(buf), "Agent:%s", agent_ok ? "ok" : "offline");
+    TextBuf(buf, LINE_BUF).str("Agent:").str(agent_ok ? "ok" : "offline");
     Paint_DrawString_EN(30, iy + 1, buf, &Font16, WHITE, BLACK);
 
     drawIconHome(140, iy, home_ok);
-    snprintf(buf, sizeof(buf), "Home:%s", home_ok ? "ok" : "offline");
+    TextBuf(buf, LINE_BUF).str("Home:").str(home_ok ? "ok" : "offline");
     Paint_DrawString_EN(158, iy + 1, buf, &Font16, WHITE, BLACK);
 
     drawIconGateway(268, iy, gw_ok);
-    snprintf(buf, sizeof(buf), "GW:%s", gw_ok ? "ok" : "offline");
+    TextBuf(buf, LINE_BUF).str("GW:").str(gw_ok ? "ok" : "offline");
     Paint_DrawString_EN(286, iy + 1, buf, &Font16, WHITE, BLACK);
 
     drawDottedLine(250);
 
     // Killswitch state: badge only for alarm, plain text otherwise
     bool ks_isolated = isIsolated();
-    snprintf(buf, sizeof(buf), "Killswitch: %s",
-             killswitch.received ? killswitch.state : "---");
+    TextBuf(buf, LINE_BUF).str("Killswitch: ").str(killswitch.received ? killswitch.state : "---");
     if (ks_isolated) {
         drawBadge(12, 254, buf, &Font16);
     } else {
@@ -669,9 +1047,8 @@ static void renderHomePage() {
     // Footer: Web3 chain + uptime + messages
     Paint_DrawString_EN(12, 274, killswitch.ws_connected ? "Web3 chain: ok" : "Web3 chain: --",
                         &Font16, WHITE, BLACK);
-    snprintf(buf, sizeof(buf), "up: %.5s  %d msg",
-             health.received && health.up[0] ? health.up : "--",
-             health.received ? health.msgs_24h : 0);
+    TextBuf(buf, LINE_BUF).str("up: ").str(health.received && health.up[0] ? health.up : "--", 5)
+                          .str("  ").num(health.received ? health.msgs_24h : 0).str(" msg");
     Paint_DrawString_EN(220, 274, buf, &Font16, WHITE, BLACK);
 
     drawDoubleLine(290);
@@ -680,15 +1057,15 @@ static void renderHomePage() {
 // ─── Screen: BREATH (environment detail) ───────────────────────
 
 static void renderBreathPage() {
-    char buf[48];
+    char *buf = scratch.str(LINE_BUF);
+    if (!buf) return;
 
     drawCyberHeader(8, "ENVIRONMENT SCAN");
     drawDoubleLine(32);
 
     if (sensor.ok) {
         // CO2 hero number
-        snprintf(buf, sizeof(buf), "CO2  %.0f  ppm", sensor.co2);
-        int tw = strlen(buf) * Layout::FONT24_W;
+        int tw = TextBuf(buf, LINE_BUF).str("CO2  ").fixed(sensor.co2, 0).str("  ppm").len() * Layout::FONT24_W;
         Paint_DrawString_EN((DISPLAY_W - tw) / 2, 42, buf, &Font24, WHITE, BLACK);
 
         // Triple-frame progress bar
@@ -696,7 +1073,7 @@ static void renderBreathPage() {
         Paint_DrawRectangle(bx, by, bx + bbar_w, by + bh, BLACK, DOT_PIXEL_1X1, DRAW_FILL_EMPTY);
         Paint_DrawRectangle(bx + 2, by + 2, bx + bbar_w - 2, by + bh - 2, BLACK, DOT_PIXEL_1X1, DRAW_FILL_EMPTY);
         int co2v = clampedCO2();
-        int fill_w = (co2v * (bbar_w - 6)) / Layout::CO2_MAX;
+        int fill_w = (co2v * (bbar_w - 6)) / (int)config.co2_max;
         if (fill_w > 0)
             Paint_DrawRectangle(bx + 3, by + 3, bx + 3 + fill_w, by + bh - 3,
                                 BLACK, DOT_PIXEL_1X1, DRAW_FILL_FULL);
@@ -707,9 +1084,9 @@ static void renderBreathPage() {
         drawDottedLine(114);
 
         // Thermal + Moisture panels
-        snprintf(buf, sizeof(buf), "%.1f C", sensor.temp);
+        TextBuf(buf, LINE_BUF).fixed(sensor.temp, 1).str(" C");
         drawLabeledPanel(20, 120, 170, 40, "THERMAL", drawIconThermo, buf);
-        snprintf(buf, sizeof(buf), "%.0f %%", sensor.hum);
+        TextBuf(buf, LINE_BUF).fixed(sensor.hum, 0).str(" %");
         drawLabeledPanel(210, 120, 170, 40, "MOISTURE", drawIconDrop, buf);
 
         drawDottedLine(168);
@@ -727,9 +1104,9 @@ static void renderBreathPage() {
     Paint_DrawString_EN(28, vy + 2, health.received && health.up[0] ? health.up : "--", &Font16, WHITE, BLACK);
 
     if (health.received) {
-        snprintf(buf, sizeof(buf), "[mem] %dM", health.mem);
+        TextBuf(buf, LINE_BUF).str("[mem] ").num(health.mem).chr('M');
         Paint_DrawString_EN(130, vy + 2, buf, &Font16, WHITE, BLACK);
-        snprintf(buf, sizeof(buf), "[dsk] %d%%", health.disk);
+        TextBuf(buf, LINE_BUF).str("[dsk] ").num(health.disk).chr('%');
         Paint_DrawString_EN(270, vy + 2, buf, &Font16, WHITE, BLACK);
     }
 
@@ -737,7 +1114,7 @@ static void renderBreathPage() {
     if (isIsolated()) {
         drawBadge(Layout::MARGIN_L, ay, "AI:ISOLATED", &Font16);
     } else if (health.received) {
-        snprintf(buf, sizeof(buf), "AI:ok %dmsg %.10s", health.msgs_24h, health.model[0] ? health.model : "");
+        TextBuf(buf, LINE_BUF).str("AI:ok ").num(health.msgs_24h).str("msg ").str(health.model, 10);
         Paint_DrawString_EN(12, ay + 1, buf, &Font16, WHITE, BLACK);
     } else {
         Paint_DrawString_EN(12, ay + 1, "AI: --", &Font16, WHITE, BLACK);
@@ -748,13 +1125,12 @@ static void renderBreathPage() {
 
     drawDoubleLine(sy + 20);
     int bly = sy + 28;
-    snprintf(buf, sizeof(buf), "Web3:%s  KS:%s",
-             killswitch.ws_connected ? "ok" : "--",
-             killswitch.received ? killswitch.state : "--");
+    TextBuf(buf, LINE_BUF).str("Web3:").str(killswitch.ws_connected ? "ok" : "--")
+                          .str("  KS:").str(killswitch.received ? killswitch.state : "--");
     Paint_DrawString_EN(12, bly, buf, &Font16, WHITE, BLACK);
 
     int rssi = WiFi.RSSI();
-    snprintf(buf, sizeof(buf), "WiFi:%ddB", rssi);
+    TextBuf(buf, LINE_BUF).str("WiFi:").num(rssi).str("dB");
     Paint_DrawString_EN(290, bly, buf, &Font16, WHITE, BLACK);
 }
 
@@ -783,7 +1159,8 @@ static void drawLink(int x1, int y1, int x2, int y2, bool healthy) {
 }
 
 static void renderNervePage() {
-    char buf[48];
+    char *buf = scratch.str(LINE_BUF);
+    if (!buf) return;
 
     drawCyberHeader(8, "NERVE MAP");
     drawWiFiStatus(316, 10);
@@ -798,12 +1175,12 @@ static void renderNervePage() {
     drawNodeBox(inet_x, inet_y, inet_w, inet_h, inet_ok);
     Paint_DrawString_EN(inet_x + 10, inet_y + 6, "INTERNET", &Font16, WHITE, BLACK);
     if (health.received) {
-        snprintf(buf, sizeof(buf), "%dms", health.inet_ms);
+        TextBuf(buf, LINE_BUF).num(health.inet_ms).str("ms");
         Paint_DrawString_EN(inet_x + inet_w + 4, inet_y + 6, buf, &Font16, WHITE, BLACK);
     }
 
     // Connection: Internet → Gateway
-    int cx = 200;
+    int cx = Layout::CENTER_X;
     int link1_top = inet_y + inet_h;
     int link1_bot = inet_y + inet_h + 16;
     drawLink(cx, link1_top, cx, link1_bot, inet_ok);
@@ -832,23 +1209,24 @@ static void renderNervePage() {
     drawLink(ha_cx, branch_y, ha_cx, child_y, ha_ok);
 
     if (health.received) {
-        snprintf(buf, sizeof(buf), "%dms", health.gw_ms);
+        TextBuf(buf, LINE_BUF).num(health.gw_ms).str("ms");
         Paint_DrawString_EN(agent_cx - 28, branch_y - 14, buf, &Font16, WHITE, BLACK);
-        snprintf(buf, sizeof(buf), "%dms", health.ha_ms);
+        TextBuf(buf, LINE_BUF).num(health.ha_ms).str("ms");
         Paint_DrawString_EN(ha_cx + 6, branch_y - 14, buf, &Font16, WHITE, BLACK);
     }
 
     // AI AGENT + SMART HOME nodes
     int ag_w = 120, ag_h = 48;
-    char model_trunc[12];
-    snprintf(model_trunc, sizeof(model_trunc), "%.9s", health.model[0] ? health.model : "---");
+    char *model_trunc = scratch.str(LINE_BUF);
+    if (!model_trunc) return;
+    TextBuf(model_trunc, LINE_BUF).str(health.model[0] ? health.model : "---", 9);
     drawNodeCard(agent_cx, child_y, ag_w, ag_h, health.received,
                  "AI AGENT", "10.0.0.2", model_trunc);
     drawNodeCard(ha_cx, child_y, ag_w, ag_h, ha_ok,
                  "SMART HOME", "10.0.0.3", "HA+MQTT");
 
     // Converge to TORII-INK
-    int torii_cx = 200;
+    int torii_cx = Layout::CENTER_X;
     int torii_y = child_y + ag_h + 16;
     drawLink(agent_cx, child_y + ag_h, torii_cx - 30, torii_y, true);
     drawLink(ha_cx, child_y + ag_h, torii_cx + 30, torii_y, true);
@@ -861,35 +1239,14 @@ static void renderNervePage() {
 
 // ─── Screen: ISOLATED (killswitch active) ──────────────────────
 
-// Shield icon
-static void drawShield(int cx, int cy, int s, bool filled) {
-    int w = s * 3 / 4;
-    int top = cy - s, mid = cy + s / 3, bot = cy + s;
-    Paint_DrawLine(cx - w, top, cx + w, top, BLACK, DOT_PIXEL_2X2, LINE_STYLE_SOLID);
-    Paint_DrawLine(cx - w, top, cx - w, mid, BLACK, DOT_PIXEL_2X2, LINE_STYLE_SOLID);
-    Paint_DrawLine(cx + w, top, cx + w, mid, BLACK, DOT_PIXEL_2X2, LINE_STYLE_SOLID);
-    Paint_DrawLine(cx - w, mid, cx, bot, BLACK, DOT_PIXEL_2X2, LINE_STYLE_SOLID);
-    Paint_DrawLine(cx + w, mid, cx, bot, BLACK, DOT_PIXEL_2X2, LINE_STYLE_SOLID);
-    if (filled) {
-        for (int y = top + 2; y < mid; y++)
-            Paint_DrawLine(cx - w + 2, y, cx + w - 2, y, BLACK, DOT_PIXEL_1X1, LINE_STYLE_SOLID);
-        for (int y = mid; y < bot; y++) {
-            int narrow = w * (y - mid) / (bot - mid);
-            int lx = cx - w + narrow + 2, rx = cx + w - narrow - 2;
-            if (lx < rx) Paint_DrawLine(lx, y, rx, y, BLACK, DOT_PIXEL_1X1, LINE_STYLE_SOLID);
-        }
-    }
+// Shield icon (s = 16), centred on cx/cy
+static void drawShield(int cx, int cy, bool filled) {
+    drawSprite(filled ? SPRITE_SHIELD : SPRITE_SHIELD_EMPTY, cx, cy);
 }
 
-// Warning triangle with exclamation mark
-static void drawWarning(int cx, int top_y, int h) {
-    int w = h * 2 / 3;
-    int bot = top_y + h;
-    Paint_DrawLine(cx, top_y, cx - w, bot, BLACK, DOT_PIXEL_2X2, LINE_STYLE_SOLID);
-    Paint_DrawLine(cx, top_y, cx + w, bot, BLACK, DOT_PIXEL_2X2, LINE_STYLE_SOLID);
-    Paint_DrawLine(cx - w, bot, cx + w, bot, BLACK, DOT_PIXEL_2X2, LINE_STYLE_SOLID);
-    Paint_DrawLine(cx, top_y + h / 3, cx, bot - h / 3, BLACK, DOT_PIXEL_2X2, LINE_STYLE_SOLID);
-    Paint_DrawCircle(cx, bot - 4, 2, BLACK, DOT_PIXEL_1X1, DRAW_FILL_FULL);
+// Warning triangle with exclamation mark (h = 30), apex at cx/top_y
+static void drawWarning(int cx, int top_y) {
+    drawSprite(SPRITE_WARNING, cx, top_y);
 }
 
 // Connection topology
@@ -926,17 +1283,17 @@ static void renderIsolatedPage() {
     }
 
     // Full black banner header
-    Paint_DrawRectangle(0, 0, 399, 50, BLACK, DOT_PIXEL_1X1, DRAW_FILL_FULL);
-    Paint_DrawRectangle(2, 2, 397, 48, WHITE, DOT_PIXEL_1X1, DRAW_FILL_EMPTY);
+    Paint_DrawRectangle(0, 0, DISPLAY_W - 1, 50, BLACK, DOT_PIXEL_1X1, DRAW_FILL_FULL);
+    Paint_DrawRectangle(2, 2, DISPLAY_W - 3, 48, WHITE, DOT_PIXEL_1X1, DRAW_FILL_EMPTY);
 
     // Warning triangles in banner (white)
     Paint_DrawLine(24, 12, 10, 38, WHITE, DOT_PIXEL_2X2, LINE_STYLE_SOLID);
     Paint_DrawLine(24, 12, 38, 38, WHITE, DOT_PIXEL_2X2, LINE_STYLE_SOLID);
     Paint_DrawLine(10, 38, 38, 38, WHITE, DOT_PIXEL_2X2, LINE_STYLE_SOLID);
 
-    Paint_DrawLine(376, 12, 362, 38, WHITE, DOT_PIXEL_2X2, LINE_STYLE_SOLID);
-    Paint_DrawLine(376, 12, 390, 38, WHITE, DOT_PIXEL_2X2, LINE_STYLE_SOLID);
-    Paint_DrawLine(362, 38, 390, 38, WHITE, DOT_PIXEL_2X2, LINE_STYLE_SOLID);
+    Paint_DrawLine(DISPLAY_W - 24, 12, DISPLAY_W - 38, 38, WHITE, DOT_PIXEL_2X2, LINE_STYLE_SOLID);
+    Paint_DrawLine(DISPLAY_W - 24, 12, DISPLAY_W - 10, 38, WHITE, DOT_PIXEL_2X2, LINE_STYLE_SOLID);
+    Paint_DrawLine(DISPLAY_W - 38, 38, DISPLAY_W - 10, 38, WHITE, DOT_PIXEL_2X2, LINE_STYLE_SOLID);
 
     // "ISOLATED" white on black
     Paint_DrawString_EN(132, 14, "ISOLATED", &Font24, BLACK, WHITE);
@@ -945,7 +1302,7 @@ static void renderIsolatedPage() {
     drawQR(20, 60, 2);
 
     // Warning triangle + explanation
-    drawWarning(170, 58, 30);
+    drawWarning(170, 58);
     Paint_DrawString_EN(200, 60, "AGENT CUT OFF", &Font20, WHITE, BLACK);
 
     // Traffic dropped badge
@@ -955,8 +1312,9 @@ static void renderIsolatedPage() {
     Paint_DrawRectangle(20, 120, 380, 168, BLACK, DOT_PIXEL_2X2, DRAW_FILL_EMPTY);
     drawBlockNumber(30, 126, &Font20);
     if (killswitch.isolated_at[0]) {
-        char iso_buf[40];
-        snprintf(iso_buf, sizeof(iso_buf), "Isolated at: %s", killswitch.isolated_at);
+        char *iso_buf = scratch.str(LINE_BUF);
+        if (!iso_buf) return;
+        TextBuf(iso_buf, LINE_BUF).str("Isolated at: ").str(killswitch.isolated_at);
         Paint_DrawString_EN(30, 148, iso_buf, &Font16, WHITE, BLACK);
     }
 
@@ -968,25 +1326,108 @@ static void renderIsolatedPage() {
     drawBadge(20, 238, "Launch(param=true)", &Font16);
 
     // Inverted bottom bar
-    Paint_DrawRectangle(0, 270, 399, 299, BLACK, DOT_PIXEL_1X1, DRAW_FILL_FULL);
-    Paint_DrawString_EN(72, 276, "KILLSWITCH ACTIVE", &Font24, BLACK, WHITE);
+    Paint_DrawRectangle(0, DISPLAY_H - 30, DISPLAY_W - 1, DISPLAY_H - 1, BLACK, DOT_PIXEL_1X1, DRAW_FILL_FULL);
+    Paint_DrawString_EN(72, DISPLAY_H - 24, "KILLSWITCH ACTIVE", &Font24, BLACK, WHITE);
+}
+
+// ─── Screen: EVENTS (scrolling event log) ──────────────────────
+// Newest line at the bottom. While the screen is up, new lines scroll in
+// without a transition: the window is moved up in the front buffer, only
+// the new rows are drawn and only the window is refreshed (scrollEventLog()).
+
+namespace LogWindow {
+    constexpr int Y0    = 40;                  // full width, rows Y0..Y1-1
+    constexpr int ROW_H = 18;
+    constexpr int ROWS  = (DISPLAY_H - 44 - Y0) / ROW_H;   // 12, 17 in portrait
+    constexpr int Y1    = Y0 + ROWS * ROW_H;               // 256
+}
+
+static void drawEventRow(int row, const EventLine &e) {
+    char *buf = scratch.str(LINE_BUF);
+    if (!buf) return;
+    int y = LogWindow::Y0 + row * LogWindow::ROW_H;
+    TextBuf(buf, LINE_BUF).num((int32_t)(e.t_s / 3600), 2, '0').chr(':')
+                          .num((int32_t)(e.t_s / 60 % 60), 2, '0').chr(':')
+                          .num((int32_t)(e.t_s % 60), 2, '0').chr(' ').str(e.text);
+    Paint_PushClip(0, y, DISPLAY_W, y + LogWindow::ROW_H);   // a long line never bleeds into the next
+    Paint_DrawString_EN(Layout::MARGIN_L, y + 1, buf, &Font16, WHITE, BLACK);
+    Paint_PopClip();
+}
+
+static void drawEventWindow() {
+    Paint_ClearWindows(0, LogWindow::Y0, DISPLAY_W, LogWindow::Y1, WHITE);
+    uint16_t n = events.count() < LogWindow::ROWS ? events.count() : LogWindow::ROWS;
+    if (n == 0)
+        Paint_DrawString_EN(Layout::MARGIN_L, LogWindow::Y0 + 1, "No events yet.", &Font16, WHITE, BLACK);
+    for (uint16_t i = 0; i < n; i++)
+        drawEventRow(LogWindow::ROWS - 1 - i, events.recent(i));
+    event_view.shown = events.total();
+}
+
+static void renderEventsPage() {
+    drawCyberHeader(8, "EVENT LOG");
+    drawEventWindow();
+    drawDoubleLine(LogWindow::Y1 + 6);
+    Paint_DrawString_EN(30, LogWindow::Y1 + 16, "uptime clock, newest last", &Font16, WHITE, BLACK);
+}
+
+// Lines that arrived since the window was drawn, straight into the front
+// buffer. Several arrivals during one waveform coalesce into one scroll;
+// more than a window's worth (or the first line) redraws the window.
+static void scrollEventLog() {
+    const size_t stride = SurfaceInfo::STRIDE;
+    uint32_t fresh = events.total() - event_view.shown;
+    unsigned long start = millis();
+
+    ScratchScope frame(scratch);
+    Paint_SelectImage(framebuffer);
+    if (event_view.shown == 0 || fresh >= LogWindow::ROWS) {
+        drawEventWindow();
+    } else {
+        int band = (int)fresh * LogWindow::ROW_H;
+        memmove(framebuffer + LogWindow::Y0 * stride, framebuffer + (LogWindow::Y0 + band) * stride,
+                (LogWindow::Y1 - LogWindow::Y0 - band) * stride);
+        Paint_ClearWindows(0, LogWindow::Y1 - band, DISPLAY_W, LogWindow::Y1, WHITE);
+        for (uint32_t i = 0; i < fresh; i++)
+            drawEventRow(LogWindow::ROWS - 1 - i, events.recent(i));
+        event_view.shown = events.total();
+    }
+
+    // Widget waveform over the window only; every Nth pass a clean
+    bool clean = ++event_view.partials >= EVENT_PARTIALS_PER_CLEAN;
+    if (clean) event_view.partials = 0;
+    if (clean)
+        showSurfaceClean(0, LogWindow::Y0, DISPLAY_W, LogWindow::Y1);
+    else
+        showSurfaceWindow(0, LogWindow::Y0, DISPLAY_W, LogWindow::Y1, PANEL_WAVE_WIDGET);
+    esp_task_wdt_reset();
+    Serial.printf("EVENTS: %lu line(s) scrolled in %lums\n", (unsigned long)fresh, millis() - start);
 }
 
 // ─── Navigation ────────────────────────────────────────────────
 
-static void transitionTo(Screen to) {
-    if (!framebuffer) return;
+// A killswitch flip is on the glass once its waveform ends; with async
+// refreshes that is noticed here, from loop() and before the next swap
+static void latencyRefreshDone() {
+    if (!lat.ks_refreshing || Panel::busy()) return;
+    lat.ks_refreshing = false;
+    lat.refresh_ms.add(Panel::lastDone() - lat.refreshing_rx_ms);
+    publishLatency("flip");
+}
 
+static void transitionTo(Screen to) {
     Screen from = nav.screen;
 
     // Decide refresh type
     bool entering_isolation = (to == ISOLATED && from != ISOLATED && from != ISOLATED_HOME);
     bool leaving_isolation  = ((to == HOME) && (from == ISOLATED || from == ISOLATED_HOME));
-    bool full = entering_isolation || leaving_isolation || (nav.fast_count % FULL_REFRESH_EVERY == 0);
-    nav.fast_count++;
+    bool full = entering_isolation || leaving_isolation || !PanelInfo::has(PANEL_CAP_FAST) ||
+                (nav.fast_count % (int)config.full_every == 0);
 
-    // Render
-    Paint_SelectImage(framebuffer);
+    // Render (all transient text buffers come from the per-frame scratch scope)
+    // Drawn into the back buffer, so this overlaps the previous waveform
+    ScratchScope frame(scratch);
+    Paint_SelectImage(backbuffer);
     Paint_Clear(WHITE);
     drawCornerBrackets();
 
@@ -1004,17 +1445,72 @@ static void transitionTo(Screen to) {
         case DETAIL_NERVE:
             renderNervePage();
             break;
+        case EVENTS:
+            renderEventsPage();
+            break;
+        case REMOTE:
+            // Content only arrives over MQTT; nothing to render locally
+            break;
     }
+    if (lat.ks_pending) lat.render_us.add(micros() - lat.ks_rx_us);
+    remote.valid = false;
+    remote.dirty = false;
+    remote.refresh_pending = false;
+
+    // Rows that differ from the frame on the panel, while its waveform may
+    // still be running. Nothing changed: no swap, no push, no waveform. A
+    // redraw of the same screen that only touches a band of rows goes out
+    // as a window over that band.
+    unsigned long diff_us = micros();
+    FrameDiff diff;
+    bool known = nav.front_on_panel;
+    if (known) frameDiff(backbuffer, framebuffer, SurfaceInfo::STRIDE, DISPLAY_H, &diff);
+    diff_us = micros() - diff_us;
+    // A due full refresh still runs on an identical frame: clearing the
+    // ghosting is its job, and only pushes count towards the next one
+    if (known && !full && diff.changed == 0) {
+        lat.ks_pending = false;   // nothing new reaches the glass
+        nav.screen = to;
+        nav.last_transition = millis();
+        if (to == HOME || to == ISOLATED_HOME)
+            nav.last_home_refresh = millis();
+        Serial.printf("NAV: %d -> %d (unchanged, diff %luus)\n", from, to, diff_us);
+        return;
+    }
+    nav.fast_count++;
+    bool window = known && !full && to == from && PanelInfo::has(PANEL_CAP_WINDOW) &&
+                  (diff.y1 - diff.y0) * 2 <= DISPLAY_H;
 
-    // Refresh display
-    if (full) {
-        EPD_4IN2_V2_Init();
-        EPD_4IN2_V2_Display(framebuffer);
-        EPD_4IN2_V2_Init_Fast(Seconds_1_5S);
+    // Swap when BUSY releases: the controller takes no new image while a
+    // waveform runs. The refresh itself is started and left running.
+    Panel::waitIdle();
+    esp_task_wdt_reset();
+    latencyRefreshDone();
+    UBYTE *drawn = backbuffer;
+    backbuffer  = framebuffer;
+    framebuffer = drawn;
+
+    // Refresh display (wakes the controller and re-inits only on mode change)
+    if (window) {
+        // The OTP partial waveform unless the build enables the uploaded
+        // LUTs (EPD_UPLOADED_LUTS); every Nth window is a clean instead
+        bool clean = ++nav.window_count >= DIFF_WINDOWS_PER_CLEAN;
+        if (clean) nav.window_count = 0;
+        if (clean)
+            showSurfaceClean(0, diff.y0, DISPLAY_W, diff.y1);
+        else
+            showSurfaceWindow(0, diff.y0, DISPLAY_W, diff.y1, PANEL_WAVE_WIDGET);
+    } else if (full) {
+        Panel::showFull(framebuffer);
     } else {
-        EPD_4IN2_V2_Display_Fast(framebuffer);
+        Panel::showFast(framebuffer);
+    }
+    nav.front_on_panel = true;
+    if (lat.ks_pending) {
+        lat.ks_pending = false;
+        lat.ks_refreshing = true;
+        lat.refreshing_rx_ms = lat.ks_rx_ms;
     }
-    esp_task_wdt_reset();
 
     // Update state
     nav.screen = to;
@@ -1022,27 +1518,409 @@ static void transitionTo(Screen to) {
     if (to == HOME || to == ISOLATED_HOME)
         nav.last_home_refresh = millis();
 
-    Serial.printf("NAV: %d -> %d (%s)\n", from, to, full ? "full" : "fast");
+    Serial.printf("NAV: %d -> %d (%s) rows=%u diff=%luus scratch=%u/%u stack_free=%u\n", from, to,
+                  window ? "window" : full ? "full" : "fast", known ? diff.changed : DISPLAY_H, diff_us,
+                  (unsigned)scratch.highWater(), (unsigned)scratch.capacity(),
+                  (unsigned)uxTaskGetStackHighWaterMark(NULL));
+}
+
+// ─── Remote frames ─────────────────────────────────────────────
+
+static void publishFrameAck(uint16_t seq, const char *status) {
+    if (!mqtt.connected()) return;
+    ScratchScope scope(scratch);
+    char *buf = scratch.str(LINE_BUF);
+    if (!buf) return;
+    snprintf(buf, LINE_BUF, "{\"seq\":%u,\"status\":\"%s\",\"have\":%d}",
+             seq, status, remote.valid ? (int)remote.seq : -1);
+    mqtt.publish(topic(TOPIC_FRAME_ACK), buf);
+}
+
+// Grows the pending refresh region; the ack goes out once a batch is complete
+static void markRemoteDirty(uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1,
+                            uint16_t seq, bool defer) {
+    if (!remote.dirty) {
+        remote.x0 = x0; remote.y0 = y0; remote.x1 = x1; remote.y1 = y1;
+    } else {
+        if (x0 < remote.x0) remote.x0 = x0;
+        if (y0 < remote.y0) remote.y0 = y0;
+        if (x1 > remote.x1) remote.x1 = x1;
+        if (y1 > remote.y1) remote.y1 = y1;
+    }
+    remote.valid = true;
+    remote.seq = seq;
+    remote.dirty = true;
+    nav.screen = REMOTE;
+    nav.last_transition = millis();
+    if (!defer) {
+        remote.refresh_pending = true;
+        publishFrameAck(seq, "ok");
+    }
+}
+
+// Applies a patch straight into the framebuffer; the refresh itself runs
+// from loop() so DEFER'd patches can be batched into one waveform.
+static void handleFramePatch(const uint8_t *data, unsigned int length) {
+    FramePatch p;
+    // Patches may cover a row's padding bits, so the width is in whole bytes
+    FrameResult r = framePatchParse(data, length, SurfaceInfo::STRIDE * 8, DISPLAY_H, &p);
+    if (r != FRAME_OK) {
+        Serial.printf("FRAME: rejected (%s)\n", frameResultName(r));
+        publishFrameAck(0, frameResultName(r));
+        return;
+    }
+    if (isIsolated()) {
+        publishFrameAck(p.seq, "busy");  // killswitch screens own the panel
+        return;
+    }
+    bool key = p.flags & FRAME_FLAG_KEY;
+    if (!key && (!remote.valid || p.base_seq != remote.seq)) {
+        Serial.printf("FRAME: seq %u needs base %u, resync\n", p.seq, p.base_seq);
+        publishFrameAck(p.seq, "resync");
+        return;
+    }
+
+    nav.front_on_panel = false;   // even a failed apply may have written rows
+    r = framePatchApply(p, framebuffer, SurfaceInfo::STRIDE);
+    if (r != FRAME_OK) {
+        Serial.printf("FRAME: seq %u %s\n", p.seq, frameResultName(r));
+        publishFrameAck(p.seq, frameResultName(r));
+        return;
+    }
+
+    uint16_t x1 = p.x + p.w < DISPLAY_W ? p.x + p.w : DISPLAY_W;
+    markRemoteDirty(p.x, p.y, x1, p.y + p.h, p.seq, p.flags & FRAME_FLAG_DEFER);
+}
+
+// Images a draw list can reference by index (DL_OP_IMAGE)
+static const DrawImage draw_images[] = {
+    { hiki_normal,  MASCOT_W, MASCOT_H },
+    { hiki_worried, MASCOT_W, MASCOT_H },
+};
+
+static void handleDrawList(const uint8_t *data, unsigned int length) {
+    if (isIsolated()) {
+        publishFrameAck(length >= DL_HEADER_LEN ? (data[2] | (data[3] << 8)) : 0, "busy");
+        return;
+    }
+    ScratchScope scope(scratch);
+    DrawEnv env = { DISPLAY_W, DISPLAY_H, draw_images,
+                    (uint8_t)(sizeof(draw_images) / sizeof(draw_images[0])),
+                    qr_modules, QR_VERSION,
+                    (int16_t *)scratch.alloc((DISPLAY_W + 2) * sizeof(int16_t)) };
+    DrawResult res;
+    unsigned long start = micros();
+    Paint_SelectImage(framebuffer);
+    DrawStatus st = drawListRun(data, length, env, &res);
+    if (st != DL_OK) {
+        // Nothing was drawn: the framebuffer still holds remote.seq
+        Serial.printf("DRAW: seq %u failed at op %u (%s)\n", res.seq, res.ops, drawStatusName(st));
+        publishFrameAck(res.seq, drawStatusName(st));
+        return;
+    }
+    nav.front_on_panel = false;
+    Serial.printf("DRAW: seq %u, %u ops in %luus\n", res.seq, res.ops, micros() - start);
+    if (res.x0 == res.x1) {
+        publishFrameAck(res.seq, "empty");
+        return;
+    }
+    if (res.flags & DL_FLAG_FULL)
+        markRemoteDirty(0, 0, DISPLAY_W, DISPLAY_H, res.seq, false);
+    else  // partial windows are byte-aligned horizontally
+        markRemoteDirty(res.x0 & ~7, res.y0, (res.x1 + 7) & ~7, res.y1, res.seq, false);
+}
+
+static void refreshRemoteFrame() {
+    remote.refresh_pending = false;
+    remote.dirty = false;
+    unsigned long start = millis();
+    bool whole = remote.x0 == 0 && remote.y0 == 0 &&
+                 remote.x1 == DISPLAY_W && remote.y1 == DISPLAY_H;
+
+    // Patches use the widget waveform; every Nth pass cleans the whole
+    // panel, with uploaded LUTs without ever leaving LUT mode
+    if (whole) {
+        remote.partials = 0;
+        Panel::showFast(framebuffer);
+    } else if (++remote.partials >= REMOTE_PARTIALS_PER_FULL) {
+        remote.partials = 0;
+        showSurfaceClean(0, 0, DISPLAY_W, DISPLAY_H);
+    } else {
+        showSurfaceWindow(remote.x0, remote.y0, remote.x1, remote.y1, PANEL_WAVE_WIDGET);
+    }
+    esp_task_wdt_reset();
+    nav.last_transition = millis();
+    Serial.printf("FRAME: seq %u shown [%u,%u %ux%u] in %lums\n", remote.seq,
+                  remote.x0, remote.y0, remote.x1 - remote.x0, remote.y1 - remote.y0,
+                  millis() - start);
+}
+
+// ─── Runtime config ────────────────────────────────────────────
+
+#define CFG_TRIAL_MS 120000   // new network settings must reach the broker within this
+
+static uint8_t       cfg_pending = 0;          // CFG_EFFECT_* still to act on, from loop()
+static unsigned long cfg_trial_start = 0;      // 0 from boot: a trial survives a reboot
+static const char   *cfg_report = nullptr;     // outcome to publish once the broker is back
+
+static void publishConfigState(bool ok, const char *err) {
+    if (!mqtt.connected()) return;
+    // Longest strings plus every key still stay well under MQTT_JSON_MAX;
+    // a truncated document is never published on the retained topic
+    const size_t sz = MQTT_JSON_MAX;
+    ScratchScope scope(scratch);
+    char *buf = scratch.str(sz);
+    if (!buf) return;
+    int n = snprintf(buf, sz, "{\"ok\":%s,\"error\":\"%s\",\"reboot\":%s,\"config\":",
+                     ok ? "true" : "false", err,
+                     (cfg_pending & CFG_EFFECT_REBOOT) ? "true" : "false");
+    size_t cfg = n > 0 && (size_t)n < sz - 1 ? configDescribe(buf + n, sz - n - 1) : 0;
+    if (cfg == 0 || snprintf(buf + n + cfg, sz - n - cfg, "}") != 1) {
+        Serial.println("CFG: state does not fit MQTT_JSON_MAX, not published");
+        return;
+    }
+    mqtt.publish(topic(TOPIC_CONFIG_STATE), buf, true);
+}
+
+// Retained, so this also runs on every reconnect; an unchanged config is a no-op
+static void handleConfig(const char *json) {
+    uint8_t effects;
+    const char *err;
+    bool ok = configUpdate(json, &effects, &err);
+    if (!ok) Serial.printf("CFG: rejected (%s)\n", err);
+    cfg_pending |= effects;
+    publishConfigState(ok, err);
+}
+
+// Network changes wait until we're out of the MQTT callback
+static void applyPendingConfig() {
+    if (configProvisional() && (cfg_pending & (CFG_EFFECT_WIFI | CFG_EFFECT_MQTT))) {
+        cfg_trial_start = millis();
+        Serial.printf("CFG: new network settings on trial for %lus\n", (unsigned long)CFG_TRIAL_MS / 1000);
+    }
+    if (cfg_pending & CFG_EFFECT_WIFI) {
+        Serial.printf("CFG: rejoining as %s\n", config.wifi_ssid);
+        clearWiFiCache();   // cached BSSID/channel belong to the old network
+        mqtt.disconnect();
+        WiFi.disconnect();
+    }
+    if (cfg_pending & (CFG_EFFECT_WIFI | CFG_EFFECT_MQTT)) {
+        mqtt.disconnect();
+        applyBrokerTarget();
+    }
+    cfg_pending &= CFG_EFFECT_REBOOT;   // reported until the next boot
+}
+
+// Provisional network settings: keep them once the broker answers, go
+// back to the last-known-good ones if it hasn't within CFG_TRIAL_MS
+static void checkConfigTrial() {
+    if (mqtt.connected()) {
+        configConfirm();
+        Serial.println("CFG: new network settings confirmed");
+        publishConfigState(true, "");
+        return;
+    }
+    if (millis() - cfg_trial_start < CFG_TRIAL_MS) return;
+    uint8_t effects;
+    configRevert(&effects);
+    Serial.println("CFG: new network settings did not connect, reverting");
+    logEvent("Config reverted");
+    cfg_pending |= effects;   // applyPendingConfig() rejoins on the old ones
+    cfg_report = "network settings did not connect, reverted";
+}
+
+// ─── Firmware update ───────────────────────────────────────────
+
+static void publishOtaStatus() {
+    if (!mqtt.connected()) return;
+    const OtaStatus &st = otaStatus();
+    ScratchScope scope(scratch);
+    char *buf = scratch.str(160);
+    if (!buf) return;
+    snprintf(buf, 160,
+             "{\"state\":\"%s\",\"have\":%lu,\"length\":%lu,\"written\":%lu,"
+             "\"size\":%lu,\"error\":\"%s\"}",
+             otaStateName(st.state), (unsigned long)st.received, (unsigned long)st.length,
+             (unsigned long)st.written, (unsigned long)st.image_size, st.error);
+    mqtt.publish(topic(TOPIC_OTA_STATUS), buf);
+}
+
+// {"url":"http://host/fw.hs","sha256":"<hex>","size":N,"encoding":"hs"}  pull over HTTP
+// {"length":M,"sha256":"<hex>","size":N,"encoding":"hs"}               chunks follow on /ota/chunk
+// size/sha256 describe the decompressed image. Must not be published retained.
+static void handleOtaRequest(const char *json) {
+    if (otaActive()) {
+        publishOtaStatus();
+        return;
+    }
+    ScratchScope scope(scratch);
+    char *url = scratch.str(160);
+    char *sha = scratch.str(72);
+    char *sig = scratch.str(152);
+    char *enc = scratch.str(8);
+    if (!url || !sha || !sig || !enc) return;
+    jsonStr(json, "url", url, 160);
+    jsonStr(json, "sha256", sha, 72);
+    jsonStr(json, "sig", sig, 152);
+    jsonStr(json, "encoding", enc, 8);
+    uint32_t size = (uint32_t)jsonInt(json, "size");
+    bool compressed = strcmp(enc, "raw") != 0;
+
+    radioActivity("ota");
+    if (url[0])
+        otaBeginHttp(url, sha, sig, size, compressed);
+    else
+        otaBeginPush((uint32_t)jsonInt(json, "length"), sha, sig, size, compressed);
+}
+
+// u32 offset (little-endian) followed by the next slice of the transfer.
+// Every chunk is answered with a status whose "have" is the resume offset.
+static void handleOtaChunk(const uint8_t *data, unsigned int length) {
+    if (length > 4) {
+        uint32_t offset = data[0] | (data[1] << 8) | (data[2] << 16) | ((uint32_t)data[3] << 24);
+        otaPushChunk(offset, data + 4, length - 4);
+    }
+    esp_task_wdt_reset();
+    publishOtaStatus();
+}
+
+static void otaTick() {
+    if (!otaPoll()) return;
+    publishOtaStatus();
+    if (otaStatus().state == OTA_DONE) {
+        Serial.println("OTA: rebooting into new image");
+        for (int i = 0; i < 5; i++) { mqtt.loop(); delay(100); }
+        ESP.restart();
+    }
+}
+
+// ─── Local status server ───────────────────────────────────────
+
+static const char *screenName(Screen s) {
+    switch (s) {
+        case HOME:          return "home";
+        case ISOLATED:      return "isolated";
+        case ISOLATED_HOME: return "isolated_home";
+        case DETAIL_BREATH: return "detail_breath";
+        case DETAIL_NERVE:  return "detail_nerve";
+        case EVENTS:        return "events";
+        case REMOTE:        return "remote";
+    }
+    return "?";
+}
+
+static size_t statusJson(char *out, size_t sz) {
+    int n = snprintf(out, sz,
+        "{\"id\":\"%s\",\"uptime_s\":%lu,\"screen\":\"%s\","
+        "\"sensor\":{\"ok\":%s,\"co2\":%.0f,\"temp\":%.1f,\"hum\":%.0f},"
+        "\"killswitch\":\"%s\",\"health\":%s,"
+        "\"wifi\":{\"rssi\":%d,\"ip\":\"%s\"},"
+        "\"mqtt\":{\"connected\":%s,\"inflight\":%u,\"mdns_brokers\":%d},"
+        "\"radio\":\"%s\",\"ota\":\"%s\",\"remote_seq\":%d,"
+        "\"heap_free\":%lu,\"heap_min\":%lu}\n",
+        config.device_id, millis() / 1000, screenName(nav.screen),
+        sensor.ok ? "true" : "false", sensor.co2, sensor.temp, sensor.hum,
+        killswitch.state, health.received ? "true" : "false",
+        (int)WiFi.RSSI(), WiFi.localIP().toString().c_str(),
+        mqtt.connected() ? "true" : "false", outbox.inflight(), brokerCount(),
+        radio.mode == RADIO_IDLE ? "idle" : "active", otaStateName(otaStatus().state),
+        remote.valid ? (int)remote.seq : -1,
+        (unsigned long)ESP.getFreeHeap(), (unsigned long)ESP.getMinFreeHeap());
+    return n < 0 ? 0 : ((size_t)n < sz ? n : sz - 1);
+}
+
+static size_t metricsText(char *out, size_t sz) {
+    int n = snprintf(out, sz,
+        "torii_uptime_seconds %lu\n"
+        "torii_heap_free_bytes %lu\n"
+        "torii_heap_min_free_bytes %lu\n"
+        "torii_wifi_rssi_dbm %d\n"
+        "torii_mqtt_connected %d\n"
+        "torii_mqtt_inflight %u\n"
+        "torii_mqtt_sent_total %lu\n"
+        "torii_mqtt_acked_total %lu\n"
+        "torii_mqtt_retries_total %lu\n"
+        "torii_mqtt_dropped_total %lu\n"
+        "torii_mqtt_duplicates_total %lu\n"
+        "torii_radio_transitions_total %lu\n"
+        "torii_scratch_high_water_bytes %u\n"
+        "torii_scratch_failures_total %lu\n"
+        "torii_co2_ppm %.0f\n"
+        "torii_temperature_celsius %.1f\n"
+        "torii_humidity_percent %.0f\n"
+        "torii_isolated %d\n"
+        "torii_gateway_messages_total %lu\n"
+        "torii_messages_dropped_total %lu\n",
+        millis() / 1000, (unsigned long)ESP.getFreeHeap(), (unsigned long)ESP.getMinFreeHeap(),
+        (int)WiFi.RSSI(), mqtt.connected() ? 1 : 0, outbox.inflight(),
+        (unsigned long)outbox.sent(), (unsigned long)outbox.acks(),
+        (unsigned long)outbox.retries(), (unsigned long)outbox.dropped(),
+        (unsigned long)mqttTap.duplicates(), (unsigned long)radio.transitions,
+        (unsigned)scratch.highWater(), (unsigned long)scratch.failures(),
+        sensor.co2, sensor.temp, sensor.hum, isIsolated() ? 1 : 0,
+        (unsigned long)lat.rx_gateway, (unsigned long)lat.rx_dropped);
+    if (n < 0 || (size_t)n >= sz) return n < 0 ? 0 : sz - 1;
+
+    // Prometheus summaries over the last LATENCY_WINDOW samples
+    struct { const char *name; const LatencyWindow *w; } series[] = {
+        { "torii_gateway_handle_us",    &lat.handle_us },
+        { "torii_killswitch_render_us", &lat.render_us },
+        { "torii_killswitch_refresh_ms", &lat.refresh_ms },
+    };
+    ScratchScope scope(scratch);
+    uint32_t *work = (uint32_t *)scratch.alloc(LATENCY_WINDOW * sizeof(uint32_t));
+    for (size_t i = 0; work && i < sizeof(series) / sizeof(series[0]) && (size_t)n < sz; i++) {
+        LatencySummary s = series[i].w->summarize(work);
+        n += snprintf(out + n, sz - n,
+                      "%s{quantile=\"0.5\"} %lu\n%s{quantile=\"0.9\"} %lu\n"
+                      "%s{quantile=\"0.99\"} %lu\n%s_count %lu\n",
+                      series[i].name, (unsigned long)s.p50, series[i].name, (unsigned long)s.p90,
+                      series[i].name, (unsigned long)s.p99,
+                      series[i].name, (unsigned long)series[i].w->total());
+    }
+    return (size_t)n < sz ? n : sz - 1;
 }
 
+static StatusServer statusServer(statusJson, metricsText, &framebuffer, DISPLAY_W, DISPLAY_H);
+
 // ─── Main ──────────────────────────────────────────────────────
 
 void setup() {
     Serial.begin(115200);
     delay(1000);
     Serial.println("\n=== TORII-INK ===");
+    configLoad();
+    if (!topicsInit(config.device_id))
+        Serial.println("MQTT: topic arena overflow!");
+    brokerInit(config.device_id);
 
     pinMode(BTN_UP,   INPUT_PULLUP);
     pinMode(BTN_SET,  INPUT_PULLUP);
     pinMode(BTN_DOWN, INPUT_PULLUP);
 
+    // Grab the MQTT buffer before the WiFi stack starts carving up the heap
+    if (!mqtt.setBufferSize(MQTT_BUFFER_SIZE))
+        Serial.println("MQTT: buffer allocation failed!");
+
+#ifdef MQTT_TLS_CA_CERT
+    // CA parse + SSL context setup once, also ahead of the WiFi stack
+    if (!netClient.begin())
+        Serial.println("TLS: init failed, MQTT will not connect");
+#endif
+
     initDisplay();
     initSensors();
     initWiFi();
-
-    mqtt.setServer(MQTT_SERVER, MQTT_PORT);
-    mqtt.setBufferSize(512);
+    statusServer.begin();
+
+    // Configured broker first; the mDNS browse runs behind it on its own task
+#ifndef MQTT_TLS_CA_CERT
+    if (config.mqtt_mdns) Serial.println("MDNS: broker discovery needs MQTT_TLS_CA_CERT, ignored");
+#endif
+    if (mdnsBrokers()) brokerTick(WiFi.status() == WL_CONNECTED, false);
+    applyBrokerTarget();
     mqtt.setCallback(mqttCallback);
+    mqttTap.onPuback([](uint16_t id, void *) { outbox.acked(id); }, nullptr);
     connectMQTT();
 
     // Watchdog: 120s covers worst-case e-ink refresh
@@ -1085,19 +1963,31 @@ void loop() {
     if (WiFi.status() != WL_CONNECTED) {
         Serial.println("WiFi: reconnecting...");
         if (mqtt.connected()) mqtt.disconnect();
-        WiFi.disconnect(true);
-        delay(100);
-        WiFi.begin(WIFI_SSID, WIFI_PASSWORD);
-        for (int i = 0; i < 20 && WiFi.status() != WL_CONNECTED; i++) {
-            delay(500);
-            esp_task_wdt_reset();
-        }
+        connectWiFi();
     }
+    if (mdnsBrokers() && brokerTick(WiFi.status() == WL_CONNECTED, mqtt.connected()))
+        applyBrokerTarget();
     connectMQTT();
     mqtt.loop();
+    outbox.tick(mqtt.connected());
+    if (cfg_pending & ~CFG_EFFECT_REBOOT) applyPendingConfig();
+    if (configProvisional()) checkConfigTrial();
+    if (cfg_report && mqtt.connected()) {
+        publishConfigState(false, cfg_report);
+        cfg_report = nullptr;
+    }
+    otaTick();
+    statusServer.poll();
+    if (otaActive()) radioActivity("ota");
 
     unsigned long now = millis();
 
+    // Gateway frame batch complete (or its tail went missing)
+    if (remote.refresh_pending ||
+        (remote.dirty && now - nav.last_transition >= 2000)) {
+        refreshRemoteFrame();
+    }
+
     // Button edge detection (3 buttons)
     static bool prev_up = HIGH, prev_set = HIGH, prev_down = HIGH;
     static unsigned long db_up = 0, db_set = 0, db_down = 0;
@@ -1128,6 +2018,10 @@ void loop() {
     prev_down = cur_down;
     (void)btn_set_pressed;  // reserved for future use
 
+    if (btn_up_pressed || btn_set_pressed || btn_down_pressed)
+        radioActivity("button");
+    radioTick(now);
+
     // Debug: print button GPIO state every 3 seconds
     if (now - dbg_time >= 3000) {
         dbg_time = now;
@@ -1135,9 +2029,10 @@ void loop() {
     }
 
     // Periodic sensor read + MQTT publish
-    if (now - nav.last_sensor >= SENSOR_INTERVAL_MS) {
+    if (now - nav.last_sensor >= config.sensor_ms) {
         readSensors();
         publishSensors();
+        publishLatency("periodic");
         nav.last_sensor = now;
     }
 
@@ -1147,6 +2042,7 @@ void loop() {
     // Handle killswitch state change
     if (ks_changed) {
         ks_changed = false;
+        radioActivity("killswitch");
         if (isolated && nav.screen != ISOLATED && nav.screen != ISOLATED_HOME) {
             transitionTo(ISOLATED);
             return;
@@ -1155,17 +2051,18 @@ void loop() {
             transitionTo(HOME);
             return;
         }
+        lat.ks_pending = false;   // same side as before: nothing to show, nothing to time
     }
 
     // Cyclic screen navigation
-    // Normal:   HOME → DETAIL_BREATH → DETAIL_NERVE → (wrap) HOME
-    // Isolated: ISOLATED → ISOLATED_HOME → DETAIL_BREATH → DETAIL_NERVE → (wrap) ISOLATED
+    // Normal:   HOME → DETAIL_BREATH → DETAIL_NERVE → EVENTS → (wrap) HOME
+    // Isolated: ISOLATED → ISOLATED_HOME → DETAIL_BREATH → DETAIL_NERVE → EVENTS → (wrap) ISOLATED
 
     // Screen order tables
-    static const Screen cycle_normal[]   = { HOME, DETAIL_BREATH, DETAIL_NERVE };
-    static const int    cycle_normal_n   = 3;
-    static const Screen cycle_isolated[] = { ISOLATED, ISOLATED_HOME, DETAIL_BREATH, DETAIL_NERVE };
-    static const int    cycle_isolated_n = 4;
+    static const Screen cycle_normal[]   = { HOME, DETAIL_BREATH, DETAIL_NERVE, EVENTS };
+    static const int    cycle_normal_n   = 4;
+    static const Screen cycle_isolated[] = { ISOLATED, ISOLATED_HOME, DETAIL_BREATH, DETAIL_NERVE, EVENTS };
+    static const int    cycle_isolated_n = 5;
 
     auto cycleNext = [](const Screen *arr, int n, Screen cur) -> Screen {
         for (int i = 0; i < n; i++)
@@ -1192,23 +2089,40 @@ void loop() {
         // Auto-behaviors (no button pressed)
         switch (nav.screen) {
             case HOME:
-                if (now - nav.last_home_refresh >= HOME_REFRESH_MS) {
+                if (now - nav.last_home_refresh >= config.home_ms) {
                     readSensors();
                     transitionTo(HOME);
                 }
                 break;
             case DETAIL_BREATH:
             case DETAIL_NERVE:
-                if (elapsed >= DETAIL_TIMEOUT_MS) {
+                if (elapsed >= config.detail_ms) {
                     transitionTo(isolated ? ISOLATED : HOME);
                 }
                 break;
             case ISOLATED:
             case ISOLATED_HOME:
+            case EVENTS:
                 // No auto-swap — only manual navigation
                 break;
+            case REMOTE:
+                if (elapsed >= REMOTE_TIMEOUT_MS) {
+                    transitionTo(isolated ? ISOLATED : HOME);
+                }
+                break;
         }
     }
 
-    delay(100);
+    // New log lines scroll in once the panel is free; the ones that land
+    // during a waveform go in together
+    if (nav.screen == EVENTS && events.total() != event_view.shown && !Panel::busy())
+        scrollEventLog();
+
+    latencyRefreshDone();
+    if (Panel::sleepIfIdle(EPD_SLEEP_IDLE_MS))
+        Serial.println("EPD: deep sleep");
+
+    // OTA download is paced by otaPoll(); a running waveform is polled
+    // often enough that its end (and the latency stamp) is seen promptly
+    delay(otaActive() ? 1 : Panel::busy() ? 10 : 100);
 }
@@ -0,0 +1,188 @@
+#include "mqtt_qos.h"
+
+#define MQTT_PUBLISH  3
+#define MQTT_PUBACK   4
+#define MQTT_CONNACK  2
+#define QOS_TOPIC_MAX 96
+
+// ─── MqttTap ──────────────────────────────────────────────────
+
+int MqttTap::connect(IPAddress ip, uint16_t port) {
+    state_ = HDR;
+    return inner_.connect(ip, port);
+}
+
+int MqttTap::connect(const char *host, uint16_t port) {
+    state_ = HDR;
+    return inner_.connect(host, port);
+}
+
+int MqttTap::read() {
+    int c = inner_.read();
+    if (c >= 0) feed((uint8_t)c);
+    return c;
+}
+
+int MqttTap::read(uint8_t *buf, size_t size) {
+    int n = inner_.read(buf, size);
+    for (int i = 0; i < n; i++) feed(buf[i]);
+    return n;
+}
+
+void MqttTap::feed(uint8_t b) {
+    switch (state_) {
+    case HDR:
+        hdr_ = b;
+        remaining_ = 0;
+        len_shift_ = 0;
+        state_ = LEN;
+        return;
+    case LEN:
+        remaining_ |= (uint32_t)(b & 0x7F) << len_shift_;
+        len_shift_ += 7;
+        if (b & 0x80) return;
+        pos_ = 0;
+        topic_len_ = 0;
+        id_ = 0;
+        if (remaining_ == 0) {
+            packetDone();
+            state_ = HDR;
+        } else {
+            state_ = BODY;
+        }
+        return;
+    case BODY:
+        break;
+    }
+
+    // Only the few header bytes we care about are picked out of the body
+    switch (hdr_ >> 4) {
+    case MQTT_PUBLISH:
+        if (pos_ == 0) topic_len_ = (uint16_t)b << 8;
+        else if (pos_ == 1) topic_len_ |= b;
+        else if ((hdr_ & 0x06) && pos_ == 2u + topic_len_) id_ = (uint16_t)b << 8;
+        else if ((hdr_ & 0x06) && pos_ == 3u + topic_len_) id_ |= b;
+        break;
+    case MQTT_PUBACK:
+        if (pos_ == 0) id_ = (uint16_t)b << 8;
+        else if (pos_ == 1) id_ |= b;
+        break;
+    case MQTT_CONNACK:
+        if (pos_ == 0) session_present_ = b & 0x01;
+        break;
+    }
+    if (++pos_ == remaining_) {
+        packetDone();
+        state_ = HDR;
+    }
+}
+
+void MqttTap::packetDone() {
+    switch (hdr_ >> 4) {
+    case MQTT_PUBLISH: {
+        last_dup_ = false;
+        last_id_  = (hdr_ & 0x06) ? id_ : 0;
+        if (!last_id_) break;
+        // A DUP redelivery of an id we already handled means our PUBACK
+        // was lost; without the DUP bit a reused id is a new message
+        bool seen = false;
+        for (uint16_t r : recent_) seen |= r == last_id_;
+        if ((hdr_ & 0x08) && seen) {
+            last_dup_ = true;
+            duplicates_++;
+        } else if (!seen) {
+            recent_[recent_next_] = last_id_;
+            recent_next_ = (recent_next_ + 1) % QOS_RECENT_IDS;
+        }
+        break;
+    }
+    case MQTT_PUBACK:
+        if (ack_) ack_(id_, ack_ctx_);
+        break;
+    }
+}
+
+// ─── QosOutbox ────────────────────────────────────────────────
+
+bool QosOutbox::publish(const char *topic, const char *payload, bool retain) {
+    if (strlen(payload) >= QOS_PAYLOAD_MAX || strlen(topic) > QOS_TOPIC_MAX) return false;
+
+    // Newest value wins: replace a pending message for the same topic
+    Entry *slot = nullptr;
+    for (Entry &e : slots_)
+        if (e.topic == topic) { slot = &e; break; }
+    if (!slot)
+        for (Entry &e : slots_)
+            if (!e.topic) { slot = &e; break; }
+    if (!slot) {
+        slot = &slots_[0];
+        for (Entry &e : slots_)
+            if (e.sent_at < slot->sent_at) slot = &e;
+        dropped_++;
+    }
+
+    slot->topic  = topic;
+    slot->retain = retain;
+    slot->sent   = false;
+    slot->id     = next_id_;
+    next_id_     = next_id_ == 0xFFFF ? 0x8000 : next_id_ + 1;
+    strcpy(slot->payload, payload);
+    if (out_.connected()) send(*slot, false);
+    return true;
+}
+
+bool QosOutbox::send(Entry &e, bool dup) {
+    uint8_t pkt[3 + 2 + QOS_TOPIC_MAX + 2 + QOS_PAYLOAD_MAX];
+    size_t tlen = strlen(e.topic), plen = strlen(e.payload);
+    size_t remaining = 2 + tlen + 2 + plen;   // < 128, one length byte
+    size_t n = 0;
+    pkt[n++] = (MQTT_PUBLISH << 4) | (dup ? 0x08 : 0) | 0x02 | (e.retain ? 0x01 : 0);
+    pkt[n++] = (uint8_t)remaining;
+    pkt[n++] = tlen >> 8;
+    pkt[n++] = tlen & 0xFF;
+    memcpy(pkt + n, e.topic, tlen);
+    n += tlen;
+    pkt[n++] = e.id >> 8;
+    pkt[n++] = e.id & 0xFF;
+    memcpy(pkt + n, e.payload, plen);
+    n += plen;
+
+    if (out_.write(pkt, n) != n) return false;
+    e.sent_at = millis();
+    if (dup) retries_++;
+    else if (!e.sent) sent_++;
+    e.sent = true;
+    return true;
+}
+
+void QosOutbox::acked(uint16_t id) {
+    for (Entry &e : slots_) {
+        if (e.topic && e.id == id) {
+            e.topic = nullptr;
+            acks_++;
+            return;
+        }
+    }
+}
+
+void QosOutbox::tick(bool connected) {
+    if (!connected) return;
+    unsigned long now = millis();
+    for (Entry &e : slots_) {
+        if (!e.topic) continue;
+        if (!e.sent) send(e, false);
+        else if (now - e.sent_at >= QOS_RETRY_MS) send(e, true);
+    }
+}
+
+void QosOutbox::resendAll() {
+    unsigned long now = millis();
+    for (Entry &e : slots_)
+        if (e.topic && e.sent) e.sent_at = now - QOS_RETRY_MS;
+}
+
+uint8_t QosOutbox::inflight() const {
+    uint8_t n = 0;
+    for (const Entry &e : slots_) n += e.topic != nullptr;
+    return n;
+}
@@ -0,0 +1,104 @@
+#pragma once
+// QoS 1 on top of PubSubClient, which only publishes at QoS 0 and hides
+// packet ids from the callback.
+//
+// MqttTap sits between PubSubClient and the socket and parses the inbound
+// byte stream as it is read: it sees PUBACKs for our own publishes, the
+// CONNACK session-present flag, and the id/DUP bits of every inbound QoS 1
+// PUBLISH (PubSubClient still sends the PUBACK for those).
+//
+// QosOutbox owns a small in-flight window of outgoing QoS 1 publishes.
+// Nothing waits for an ack: tick() retransmits with DUP after a timeout,
+// and a newer value for the same topic replaces the one in flight.
+
+#include <Arduino.h>
+#include <Client.h>
+
+#define QOS_INFLIGHT_MAX   4
+#define QOS_PAYLOAD_MAX    24
+#define QOS_RETRY_MS       10000
+#define QOS_RECENT_IDS     8       // inbound ids remembered for duplicate detection
+
+class MqttTap : public Client {
+public:
+    typedef void (*AckHandler)(uint16_t id, void *ctx);
+
+    explicit MqttTap(Client &inner) : inner_(inner) {}
+    void onPuback(AckHandler h, void *ctx) { ack_ = h; ack_ctx_ = ctx; }
+
+    // Valid inside the PubSubClient callback for the message being delivered
+    bool     lastWasDuplicate() const { return last_dup_; }
+    uint16_t lastPacketId() const { return last_id_; }
+    bool     sessionPresent() const { return session_present_; }
+    uint32_t duplicates() const { return duplicates_; }
+
+    int connect(IPAddress ip, uint16_t port) override;
+    int connect(const char *host, uint16_t port) override;
+    size_t write(uint8_t b) override { return inner_.write(b); }
+    size_t write(const uint8_t *buf, size_t size) override { return inner_.write(buf, size); }
+    int available() override { return inner_.available(); }
+    int read() override;
+    int read(uint8_t *buf, size_t size) override;
+    int peek() override { return inner_.peek(); }
+    void flush() override { inner_.flush(); }
+    void stop() override { inner_.stop(); }
+    uint8_t connected() override { return inner_.connected(); }
+    operator bool() override { return (bool)inner_; }
+
+private:
+    enum State : uint8_t { HDR, LEN, BODY };
+
+    void feed(uint8_t b);
+    void packetDone();
+
+    Client    &inner_;
+    AckHandler ack_ = nullptr;
+    void      *ack_ctx_ = nullptr;
+
+    State    state_ = HDR;
+    uint8_t  hdr_ = 0;
+    uint32_t remaining_ = 0, pos_ = 0;
+    uint8_t  len_shift_ = 0;
+    uint16_t topic_len_ = 0, id_ = 0;
+
+    bool     last_dup_ = false, session_present_ = false;
+    uint16_t last_id_ = 0;
+    uint16_t recent_[QOS_RECENT_IDS] = {};
+    uint8_t  recent_next_ = 0;
+    uint32_t duplicates_ = 0;
+};
+
+class QosOutbox {
+public:
+    explicit QosOutbox(Client &out) : out_(out) {}
+
+    // topic must outlive the message (interned topics do). Returns false
+    // if the payload is too long; a full window evicts the oldest message.
+    bool publish(const char *topic, const char *payload, bool retain);
+    void acked(uint16_t id);
+    void tick(bool connected);
+    void resendAll();   // after reconnect, per MQTT 3.1.1 §4.4
+
+    uint8_t  inflight() const;
+    uint32_t sent() const { return sent_; }
+    uint32_t acks() const { return acks_; }
+    uint32_t retries() const { return retries_; }
+    uint32_t dropped() const { return dropped_; }
+
+private:
+    struct Entry {
+        const char   *topic = nullptr;   // nullptr = free slot
+        char          payload[QOS_PAYLOAD_MAX];
+        uint16_t      id = 0;
+        bool          retain = false;
+        bool          sent = false;      // on the wire at least once
+        unsigned long sent_at = 0;
+    };
+
+    bool send(Entry &e, bool dup);
+
+    Client  &out_;
+    Entry    slots_[QOS_INFLIGHT_MAX];
+    uint16_t next_id_ = 0x8000;          // clear of PubSubClient's subscribe ids
+    uint32_t sent_ = 0, acks_ = 0, retries_ = 0, dropped_ = 0;
+};
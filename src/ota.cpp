@@ -0,0 +1,310 @@
+#include "ota.h"
+
+#include <Arduino.h>
+#include <HTTPClient.h>
+#include <Update.h>
+#include <esp_ota_ops.h>
+#include <mbedtls/sha256.h>
+
+#include "config.h"
+
+#ifdef OTA_SIGN_KEY
+#include <mbedtls/pk.h>
+#endif
+
+#define OTA_POLL_BUDGET_MS 50      // longest a single otaPoll() reads for
+#define OTA_STALL_MS       20000   // no data for this long aborts the transfer
+#define OTA_REPORT_BYTES   32768   // progress report granularity
+#define OTA_URL_MAX        160     // request url, NUL included
+#define OTA_SIG_MAX        72      // DER ECDSA P-256 signature
+
+namespace {
+
+OtaStatus              status;
+HTTPClient             http;
+mbedtls_sha256_context sha;
+uint8_t                expected[32];
+uint8_t                rx[OTA_READ_CHUNK];
+unsigned long          last_data = 0;
+uint32_t               reported  = 0;
+OtaState               reported_state = OTA_IDLE;
+int8_t                 boot_pending = -1;   // unknown until first asked
+char                   err_buf[32];
+char                   url[OTA_URL_MAX];
+bool                   connecting = false;  // GET not sent yet, see otaPoll()
+
+void fail(const char *why) {
+    if (status.state != OTA_RECEIVING) return;
+    status.state = OTA_FAILED;
+    status.error = why;
+    Update.abort();
+    mbedtls_sha256_free(&sha);
+    if (!status.push && !connecting) http.end();
+    connecting = false;
+    Serial.printf("OTA: failed (%s) at %lu/%lu\n", why,
+                  (unsigned long)status.received, (unsigned long)status.length);
+}
+
+bool flashSink(const uint8_t *data, size_t len, void *) {
+    if (status.written + len > status.image_size) {
+        fail("image larger than announced");
+        return false;
+    }
+    if (Update.write(const_cast<uint8_t *>(data), len) != len) {
+        fail(Update.errorString());
+        return false;
+    }
+    mbedtls_sha256_update(&sha, data, len);
+    status.written += len;
+    return true;
+}
+
+HeatshrinkStream inflate(flashSink, nullptr);
+
+bool parseHex(const char *hex, uint8_t *out, size_t n) {
+    if (strlen(hex) != n * 2) return false;
+    for (size_t i = 0; i < n * 2; i++) {
+        char c = hex[i];
+        uint8_t v;
+        if (c >= '0' && c <= '9')      v = c - '0';
+        else if (c >= 'a' && c <= 'f') v = c - 'a' + 10;
+        else if (c >= 'A' && c <= 'F') v = c - 'A' + 10;
+        else return false;
+        out[i / 2] = (i & 1) ? (out[i / 2] | v) : (uint8_t)(v << 4);
+    }
+    return true;
+}
+
+#ifdef OTA_SIGN_KEY
+// sig_hex: DER ECDSA signature over the image, made with the private half
+// of OTA_SIGN_KEY. Only the announced digest is checked here; complete()
+// then holds the flashed bytes to that digest.
+bool signatureOk(const char *sig_hex) {
+    uint8_t sig[OTA_SIG_MAX];
+    size_t n = strlen(sig_hex) / 2;
+    if (n == 0 || n > sizeof(sig) || !parseHex(sig_hex, sig, n)) return false;
+
+    static const char key[] = OTA_SIGN_KEY;
+    mbedtls_pk_context pk;
+    mbedtls_pk_init(&pk);
+    bool ok = mbedtls_pk_parse_public_key(&pk, (const unsigned char *)key, sizeof(key)) == 0 &&
+              mbedtls_pk_verify(&pk, MBEDTLS_MD_SHA256, expected, sizeof(expected), sig, n) == 0;
+    mbedtls_pk_free(&pk);
+    return ok;
+}
+#endif
+
+bool begin(const char *sha256_hex, const char *sig_hex, uint32_t image_size,
+           bool compressed, bool push) {
+    if (status.state == OTA_RECEIVING) return false;
+    status = OtaStatus();
+    reported_state = OTA_IDLE;
+    status.compressed = compressed;
+    status.push       = push;
+    status.image_size = image_size;
+
+    if (!parseHex(sha256_hex, expected, sizeof(expected))) {
+        status.state = OTA_FAILED;
+        status.error = "bad sha256";
+        return false;
+    }
+#if defined(OTA_SIGN_KEY)
+    if (!signatureOk(sig_hex)) {
+        status.state = OTA_FAILED;
+        status.error = "bad signature";
+        return false;
+    }
+#elif !defined(MQTT_TLS_CA_CERT)
+    // Nothing vouches for the request: anyone on the broker could flash
+    (void)sig_hex;
+    status.state = OTA_FAILED;
+    status.error = "ota needs OTA_SIGN_KEY or TLS";
+    return false;
+#else
+    (void)sig_hex;
+#endif
+    if (image_size == 0 || !Update.begin(image_size)) {
+        status.state = OTA_FAILED;
+        status.error = image_size ? Update.errorString() : "bad size";
+        return false;
+    }
+    mbedtls_sha256_init(&sha);
+    mbedtls_sha256_starts(&sha, 0);
+    inflate.reset();
+    last_data    = millis();
+    reported     = 0;
+    status.state = OTA_RECEIVING;
+    return true;
+}
+
+void complete() {
+    if (status.compressed && !inflate.finish()) return;   // sink already failed
+    if (status.written != status.image_size) {
+        fail("image shorter than announced");
+        return;
+    }
+    uint8_t digest[32];
+    mbedtls_sha256_finish(&sha, digest);
+    if (memcmp(digest, expected, sizeof(digest)) != 0) {
+        fail("sha256 mismatch");
+        return;
+    }
+    if (!Update.end()) {
+        fail(Update.errorString());
+        return;
+    }
+    mbedtls_sha256_free(&sha);
+    if (!status.push) http.end();
+    status.state = OTA_DONE;
+    Serial.printf("OTA: %lu bytes in, %lu flashed, verified\n",
+                  (unsigned long)status.received, (unsigned long)status.written);
+}
+
+void consume(const uint8_t *data, size_t len) {
+    bool ok = status.compressed ? inflate.feed(data, len) : flashSink(data, len, nullptr);
+    if (!ok) return;
+    status.received += len;
+    last_data = millis();
+    if (status.length && status.received >= status.length) complete();
+}
+
+// Runs from otaPoll() rather than the MQTT callback that asked for the
+// update, so the GET's timeout stalls one loop pass instead of the client.
+void connect() {
+    connecting = false;
+    // HTTP/1.0 keeps the server from using chunked encoding, so the stream
+    // is the raw body
+    http.useHTTP10(true);
+    http.setTimeout(5000);
+    if (!http.begin(url)) {
+        fail("bad url");
+        return;
+    }
+    int code = http.GET();
+    if (code != HTTP_CODE_OK) {
+        snprintf(err_buf, sizeof(err_buf), "http %d", code);
+        fail(err_buf);
+        return;
+    }
+    int size = http.getSize();
+    status.length = size > 0 ? (uint32_t)size : 0;
+    last_data = millis();
+    Serial.printf("OTA: GET %s, %ld bytes -> %lu byte image (%s)\n", url, (long)size,
+                  (unsigned long)status.image_size, status.compressed ? "heatshrink" : "raw");
+}
+
+}  // namespace
+
+// Keep the core from auto-confirming a new image before setup() has run;
+// otaConfirmBoot() does it once the network path has been proven.
+extern "C" bool verifyRollbackLater() {
+    return true;
+}
+
+bool otaBeginHttp(const char *u, const char *sha256_hex, const char *sig_hex,
+                  uint32_t image_size, bool compressed) {
+    if (!begin(sha256_hex, sig_hex, image_size, compressed, false)) return false;
+    if (strlen(u) >= sizeof(url)) {
+        fail("url too long");
+        return false;
+    }
+    strcpy(url, u);
+    connecting = true;
+    return true;
+}
+
+bool otaBeginPush(uint32_t length, const char *sha256_hex, const char *sig_hex,
+                  uint32_t image_size, bool compressed) {
+    if (length == 0) return false;
+    if (!begin(sha256_hex, sig_hex, image_size, compressed, true)) return false;
+    status.length = length;
+    Serial.printf("OTA: expecting %lu pushed bytes -> %lu byte image (%s)\n",
+                  (unsigned long)length, (unsigned long)image_size,
+                  compressed ? "heatshrink" : "raw");
+    return true;
+}
+
+bool otaPushChunk(uint32_t offset, const uint8_t *data, size_t len) {
+    if (status.state != OTA_RECEIVING || !status.push) return false;
+    if (offset != status.received || len == 0) return false;
+    consume(data, len);
+    return status.state != OTA_FAILED;
+}
+
+bool otaPoll() {
+    if (otaPendingVerify() && millis() > OTA_CONFIRM_MS) {
+        Serial.println("OTA: new image never confirmed, rolling back");
+        esp_ota_mark_app_invalid_rollback_and_reboot();
+    }
+    if (status.state == OTA_RECEIVING && connecting) connect();
+    if (status.state == OTA_RECEIVING && !status.push) {
+        WiFiClient *stream = http.getStreamPtr();
+        unsigned long start = millis();
+        while (status.state == OTA_RECEIVING && millis() - start < OTA_POLL_BUDGET_MS) {
+            int avail = stream->available();
+            if (avail <= 0) {
+                if (!stream->connected()) {
+                    // Without a Content-Length, the close is the end marker
+                    if (status.length == 0) complete();
+                    else fail("connection closed early");
+                }
+                break;
+            }
+            int n = stream->read(rx, avail < (int)sizeof(rx) ? avail : sizeof(rx));
+            if (n <= 0) break;
+            consume(rx, n);
+        }
+    }
+
+    if (status.state == OTA_RECEIVING && millis() - last_data > OTA_STALL_MS)
+        fail("stalled");
+    if (status.state != reported_state) {
+        reported_state = status.state;
+        return true;
+    }
+    if (status.state == OTA_RECEIVING && status.received - reported >= OTA_REPORT_BYTES) {
+        reported = status.received;
+        return true;
+    }
+    return false;
+}
+
+void otaAbort(const char *why) {
+    fail(why);
+}
+
+bool otaActive() {
+    return status.state == OTA_RECEIVING;
+}
+
+const OtaStatus &otaStatus() {
+    return status;
+}
+
+const char *otaStateName(OtaState s) {
+    switch (s) {
+        case OTA_IDLE:      return "idle";
+        case OTA_RECEIVING: return "receiving";
+        case OTA_DONE:      return "done";
+        case OTA_FAILED:    return "failed";
+    }
+    return "?";
+}
+
+bool otaPendingVerify() {
+    if (boot_pending < 0) {
+        esp_ota_img_states_t st;
+        const esp_partition_t *running = esp_ota_get_running_partition();
+        boot_pending = esp_ota_get_state_partition(running, &st) == ESP_OK &&
+                       st == ESP_OTA_IMG_PENDING_VERIFY;
+    }
+    return boot_pending > 0;
+}
+
+void otaConfirmBoot() {
+    if (!otaPendingVerify()) return;
+    if (esp_ota_mark_app_valid_cancel_rollback() == ESP_OK) {
+        boot_pending = 0;
+        Serial.println("OTA: new image confirmed");
+    }
+}
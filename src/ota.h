@@ -0,0 +1,64 @@
+#pragma once
+// Streaming firmware update into the inactive OTA partition.
+//
+// The image arrives either pulled over HTTP (otaBeginHttp, driven from
+// otaPoll) or pushed in order as MQTT chunks (otaBeginPush/otaPushChunk).
+// Compressed images pass through HeatshrinkStream on the way to flash, so
+// the device never holds more than one network read and one output chunk.
+// The SHA-256 of the decompressed image is checked before the new partition
+// is made bootable.
+//
+// Who may ask: with OTA_SIGN_KEY (config.h) every request must carry a
+// signature over the image from the matching private key. Without it OTA
+// is accepted only over an MQTT session authenticated by MQTT_TLS_CA_CERT,
+// and refused outright on a plain-text build.
+//
+// Rollback: a freshly flashed image boots in PENDING_VERIFY and must call
+// otaConfirmBoot() (after it reaches the broker) within OTA_CONFIRM_MS, or
+// otaPoll() marks it invalid and the bootloader returns to the old one.
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "heatshrink_stream.h"
+
+#define OTA_READ_CHUNK   1024
+#define OTA_CONFIRM_MS   300000   // new image must reach MQTT within 5 minutes
+#define OTA_STATIC_RAM   (sizeof(HeatshrinkStream) + OTA_READ_CHUNK)
+
+enum OtaState : uint8_t { OTA_IDLE, OTA_RECEIVING, OTA_DONE, OTA_FAILED };
+
+struct OtaStatus {
+    OtaState    state      = OTA_IDLE;
+    bool        compressed = false;
+    bool        push       = false;   // MQTT chunks rather than HTTP
+    uint32_t    received   = 0;       // transfer bytes consumed
+    uint32_t    length     = 0;       // transfer length, 0 if the server didn't say
+    uint32_t    written    = 0;       // image bytes flashed
+    uint32_t    image_size = 0;
+    const char *error      = "";
+};
+
+// sha256_hex: 64 hex chars of the decompressed image. image_size: its length.
+// sig_hex: DER ECDSA signature over the image, checked when OTA_SIGN_KEY is set.
+// otaBeginHttp only records the url; the GET is sent from the next otaPoll().
+bool otaBeginHttp(const char *url, const char *sha256_hex, const char *sig_hex,
+                  uint32_t image_size, bool compressed);
+bool otaBeginPush(uint32_t length, const char *sha256_hex, const char *sig_hex,
+                  uint32_t image_size, bool compressed);
+
+// Chunks must arrive in order; anything else is refused and the sender
+// resumes from otaStatus().received.
+bool otaPushChunk(uint32_t offset, const uint8_t *data, size_t len);
+
+// Drives the HTTP download and the boot-confirm deadline. Returns true when
+// the status has moved enough to be worth reporting.
+bool otaPoll();
+
+void otaAbort(const char *why);
+bool otaActive();
+const OtaStatus &otaStatus();
+const char *otaStateName(OtaState s);
+
+bool otaPendingVerify();
+void otaConfirmBoot();
@@ -0,0 +1,119 @@
+#pragma once
+// Compile-time panel selection.
+//
+// Each supported controller gets a driver struct of static inline members
+// forwarding to its Waveshare-style C driver in lib/epd, plus the constants
+// PanelTraits<> reads. The firmware talks to `Panel` and asks `PanelInfo`
+// about geometry and refresh modes, so the push path is direct calls with
+// no vtable, and a different panel is a build flag:
+//
+//     build_flags = -DPANEL_EPD_4IN2_V2      (the default)
+//
+// Every driver provides the whole interface below. A controller without one
+// of the waveforms maps that call onto the nearest one it has and leaves the
+// bit out of CAPS; callers that care (refresh cadences, layouts) check
+// PanelInfo instead of the panel name.
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "DEV_Config.h"
+
+// Refresh capabilities, PanelTraits<>::has()
+#define PANEL_CAP_FAST     0x01   // whole-frame fast waveform
+#define PANEL_CAP_WINDOW   0x02   // refresh of a sub-rectangle only
+#define PANEL_CAP_LUT      0x04   // uploaded waveforms (widget / cleaning)
+#define PANEL_CAP_4GRAY    0x08
+
+// Waveforms for Panel::showWindow()
+enum PanelWave : uint8_t {
+    PANEL_WAVE_WIDGET,   // changed pixels only, least flicker
+    PANEL_WAVE_CLEAN,    // drives every pixel in the window, clears ghosting
+};
+
+template <typename Driver>
+struct PanelTraits {
+    // Controller RAM: 1 bpp, MSB = leftmost pixel, 1 = white, row-major
+    static constexpr uint16_t WIDTH       = Driver::WIDTH;
+    static constexpr uint16_t HEIGHT      = Driver::HEIGHT;
+    static constexpr uint16_t STRIDE      = (WIDTH + 7) / 8;
+    static constexpr size_t   FRAME_BYTES = (size_t)STRIDE * HEIGHT;
+    static constexpr uint16_t WINDOW_X_ALIGN = Driver::WINDOW_X_ALIGN;   // showWindow() x granularity
+
+    static constexpr uint8_t CAPS = Driver::CAPS;
+    static constexpr bool has(uint8_t cap) { return (CAPS & cap) == cap; }
+
+    static_assert(WINDOW_X_ALIGN % 8 == 0, "windows must start on a RAM byte");
+};
+
+// ─── Waveshare 4.2" V2 (SSD1683) ───────────────────────────────
+
+#include "EPD_4in2.h"
+
+struct Epd4in2V2 {
+    static constexpr const char *NAME = "4.2in V2";
+    static constexpr uint16_t WIDTH  = EPD_4IN2_V2_WIDTH;
+    static constexpr uint16_t HEIGHT = EPD_4IN2_V2_HEIGHT;
+    static constexpr uint16_t WINDOW_X_ALIGN = 8;
+    static constexpr uint8_t  CAPS = PANEL_CAP_FAST | PANEL_CAP_WINDOW | PANEL_CAP_4GRAY |
+                                     (EPD_UPLOADED_LUTS ? PANEL_CAP_LUT : 0);
+
+    static void init()            { EPD_4IN2_V2_Init(); }
+    static void clear()           { EPD_4IN2_V2_Clear(); }
+    static void setAsync(bool on) { EPD_4IN2_V2_SetAsync(on); }
+    static void setRowSource(EPD_RowSource src) { EPD_4IN2_V2_SetRowSource(src); }
+
+    // Re-inits the controller only when the refresh mode changes
+    static bool showFull(UBYTE *frame) {
+        EPD_4IN2_V2_Ensure(EPD_MODE_FULL);
+        return EPD_4IN2_V2_Display(frame);
+    }
+    static bool showFast(UBYTE *frame) {
+        EPD_4IN2_V2_Ensure(EPD_MODE_FAST_1_5S);
+        return EPD_4IN2_V2_Display_Fast(frame);
+    }
+    // `frame` is the whole frame; end coordinates are exclusive. Without
+    // PANEL_CAP_LUT both waves are the OTP partial one, which cleans nothing
+    static bool showWindow(const UBYTE *frame, UWORD x0, UWORD y0, UWORD x1, UWORD y1, PanelWave wave) {
+        return EPD_4IN2_V2_PartialDisplay_LUT(frame, x0, y0, x1, y1,
+                                              wave == PANEL_WAVE_CLEAN ? EPD_LUT_CLEAN : EPD_LUT_WIDGET);
+    }
+
+    static bool    busy()                     { return EPD_4IN2_V2_Busy(); }
+    static bool    waitIdle()                 { return EPD_4IN2_V2_WaitIdle(); }
+    static UDOUBLE lastDone()                 { return EPD_4IN2_V2_LastDone(); }
+    static bool    sleepIfIdle(UDOUBLE idle_ms) { return EPD_4IN2_V2_SleepIfIdle(idle_ms); }
+};
+
+// ─── Selection ─────────────────────────────────────────────────
+
+#if defined(PANEL_EPD_7IN5_V2) || defined(PANEL_EPD_2IN9_V2)
+#error "no driver for this panel in lib/epd yet: add its struct above and select it here"
+#else
+using Panel = Epd4in2V2;   // PANEL_EPD_4IN2_V2
+#endif
+
+using PanelInfo = PanelTraits<Panel>;
+
+// ─── Mounting ──────────────────────────────────────────────────
+// DISPLAY_ROTATE=90 or 270 (degrees clockwise, GUI_Paint's ROTATE_90 /
+// ROTATE_270 mapping) gives a portrait surface: the firmware draws on it
+// unrotated, and rotate.h turns its rows into panel order during the push.
+// The screens in main.cpp have no portrait layouts yet and refuse to build.
+
+#ifndef DISPLAY_ROTATE
+#define DISPLAY_ROTATE 0
+#endif
+static_assert(DISPLAY_ROTATE == 0 || DISPLAY_ROTATE == 90 || DISPLAY_ROTATE == 270,
+              "DISPLAY_ROTATE must be 0, 90 or 270");
+
+template <typename Traits, int Rotate>
+struct SurfaceTraits {
+    static constexpr bool     PORTRAIT    = Rotate != 0;
+    static constexpr uint16_t WIDTH       = PORTRAIT ? Traits::HEIGHT : Traits::WIDTH;
+    static constexpr uint16_t HEIGHT      = PORTRAIT ? Traits::WIDTH : Traits::HEIGHT;
+    static constexpr uint16_t STRIDE      = (WIDTH + 7) / 8;   // padded like GUI_Paint rows
+    static constexpr size_t   FRAME_BYTES = (size_t)STRIDE * HEIGHT;
+};
+
+using SurfaceInfo = SurfaceTraits<PanelInfo, DISPLAY_ROTATE>;
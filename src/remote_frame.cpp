@@ -0,0 +1,76 @@
+#include "remote_frame.h"
+
+static uint16_t rd16(const uint8_t *p) {
+    return (uint16_t)(p[0] | (p[1] << 8));
+}
+
+FrameResult framePatchParse(const uint8_t *data, size_t len,
+                            uint16_t panel_w, uint16_t panel_h, FramePatch *out) {
+    if (len < FRAME_HEADER_LEN || data[0] != FRAME_MAGIC) return FRAME_BAD_HEADER;
+
+    out->flags    = data[1];
+    out->seq      = rd16(data + 2);
+    out->base_seq = rd16(data + 4);
+    out->x        = rd16(data + 6);
+    out->y        = rd16(data + 8);
+    out->w        = rd16(data + 10);
+    out->h        = rd16(data + 12);
+    out->body     = data + FRAME_HEADER_LEN;
+    out->body_len = len - FRAME_HEADER_LEN;
+
+    if (out->w == 0 || out->h == 0) return FRAME_BAD_REGION;
+    if (out->x % 8 || out->w % 8) return FRAME_BAD_REGION;
+    if ((uint32_t)out->x + out->w > panel_w) return FRAME_BAD_REGION;
+    if ((uint32_t)out->y + out->h > panel_h) return FRAME_BAD_REGION;
+    return FRAME_OK;
+}
+
+// Walks the RLE stream; with fb == nullptr it only measures.
+static bool rleRun(const FramePatch &p, uint8_t *fb, uint16_t stride, uint32_t expect) {
+    const uint16_t row_bytes = p.w / 8;
+    const bool key = p.flags & FRAME_FLAG_KEY;
+    const uint8_t *in = p.body, *end = p.body + p.body_len;
+    uint32_t produced = 0;
+    uint16_t col = 0;
+    uint8_t *row = fb ? fb + (uint32_t)p.y * stride + p.x / 8 : nullptr;
+
+    while (in < end) {
+        uint8_t ctrl = *in++;
+        bool repeat = ctrl & 0x80;
+        uint16_t count = (ctrl & 0x7F) + 1;
+        if (repeat ? (in >= end) : (end - in < count)) return false;
+        if (produced + count > expect) return false;
+
+        if (row) {
+            for (uint16_t i = 0; i < count; i++) {
+                uint8_t v = repeat ? in[0] : in[i];
+                if (key) row[col] = v;
+                else     row[col] ^= v;
+                if (++col == row_bytes) {
+                    col = 0;
+                    row += stride;
+                }
+            }
+        }
+        in += repeat ? 1 : count;
+        produced += count;
+    }
+    return produced == expect;
+}
+
+FrameResult framePatchApply(const FramePatch &p, uint8_t *fb, uint16_t stride) {
+    uint32_t expect = (uint32_t)(p.w / 8) * p.h;
+    if (!rleRun(p, nullptr, stride, expect)) return FRAME_BAD_BODY;
+    rleRun(p, fb, stride, expect);
+    return FRAME_OK;
+}
+
+const char *frameResultName(FrameResult r) {
+    switch (r) {
+        case FRAME_OK:         return "ok";
+        case FRAME_BAD_HEADER: return "bad_header";
+        case FRAME_BAD_REGION: return "bad_region";
+        case FRAME_BAD_BODY:   return "bad_body";
+    }
+    return "?";
+}
@@ -0,0 +1,46 @@
+#pragma once
+// Gateway-rendered frame patches, received on <device>/frame.
+//
+// Wire format (little-endian):
+//    0  u8   magic 'F'
+//    1  u8   flags (FRAME_FLAG_*)
+//    2  u16  seq        frame number this patch produces
+//    4  u16  base_seq   frame the XOR delta was computed against (ignored for KEY)
+//    6  u16  x, y, w, h region in pixels; x and w multiples of 8
+//   14  ...  RLE body:  ctrl < 0x80  -> ctrl + 1 literal bytes follow
+//                       ctrl >= 0x80 -> next byte repeated (ctrl & 0x7F) + 1 times
+//
+// The decoded body is exactly (w / 8) * h bytes, row-major, in framebuffer
+// format (1 = white). It is XORed into the region, or copied for KEY patches.
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define FRAME_MAGIC       'F'
+#define FRAME_HEADER_LEN  14
+#define FRAME_FLAG_KEY    0x01   // body replaces the region instead of XOR
+#define FRAME_FLAG_DEFER  0x02   // more patches follow; hold the refresh
+
+struct FramePatch {
+    uint8_t        flags;
+    uint16_t       seq, base_seq;
+    uint16_t       x, y, w, h;
+    const uint8_t *body;
+    size_t         body_len;
+};
+
+enum FrameResult {
+    FRAME_OK = 0,
+    FRAME_BAD_HEADER,
+    FRAME_BAD_REGION,
+    FRAME_BAD_BODY,
+};
+
+FrameResult framePatchParse(const uint8_t *data, size_t len,
+                            uint16_t panel_w, uint16_t panel_h, FramePatch *out);
+
+// Checks that the body decodes to exactly the region size, then writes it
+// into fb (row stride in bytes). A malformed body leaves fb untouched.
+FrameResult framePatchApply(const FramePatch &p, uint8_t *fb, uint16_t stride);
+
+const char *frameResultName(FrameResult r);
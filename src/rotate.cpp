@@ -0,0 +1,86 @@
+#include "rotate.h"
+
+static constexpr int PW = PanelInfo::WIDTH;     // panel, landscape
+static constexpr int PH = PanelInfo::HEIGHT;
+static constexpr int PS = PanelInfo::STRIDE;
+static constexpr int SS = SurfaceInfo::STRIDE;  // surface, portrait
+
+static uint8_t band_[8][PS];
+static int     band_at_ = -1;   // first panel row in band_, -1 when stale
+
+// b[j] = column j of the 8x8 bit matrix a (rows MSB first), i.e.
+// bit 7-i of b[j] is bit 7-j of a[i] (Hacker's Delight, transpose8)
+static inline void transpose8(const uint8_t a[8], uint8_t b[8]) {
+    uint32_t x = (uint32_t)a[0] << 24 | (uint32_t)a[1] << 16 | (uint32_t)a[2] << 8 | a[3];
+    uint32_t y = (uint32_t)a[4] << 24 | (uint32_t)a[5] << 16 | (uint32_t)a[6] << 8 | a[7];
+    uint32_t t;
+
+    t = (x ^ (x >> 7)) & 0x00AA00AA;  x = x ^ t ^ (t << 7);
+    t = (y ^ (y >> 7)) & 0x00AA00AA;  y = y ^ t ^ (t << 7);
+    t = (x ^ (x >> 14)) & 0x0000CCCC; x = x ^ t ^ (t << 14);
+    t = (y ^ (y >> 14)) & 0x0000CCCC; y = y ^ t ^ (t << 14);
+
+    t = (x & 0xF0F0F0F0) | ((y >> 4) & 0x0F0F0F0F);
+    y = ((x << 4) & 0xF0F0F0F0) | (y & 0x0F0F0F0F);
+    x = t;
+
+    b[0] = x >> 24; b[1] = x >> 16; b[2] = x >> 8; b[3] = x;
+    b[4] = y >> 24; b[5] = y >> 16; b[6] = y >> 8; b[7] = y;
+}
+
+// Surface pixels x..x+7 of one row as a byte, MSB = x; x may start off a
+// byte boundary or left of the surface (those bits read as white)
+static inline uint8_t bits8(const uint8_t *row, int x) {
+    int b = x >> 3, s = x & 7;
+    uint8_t hi = b >= 0 ? row[b] : 0xFF;
+    if (!s) return hi;
+    uint8_t lo = b + 1 < SS ? row[b + 1] : 0xFF;
+    return (uint8_t)((hi << s) | (lo >> (8 - s)));
+}
+
+// Panel rows first..first+7
+static void buildBand(const uint8_t *surface, int first) {
+    uint8_t a[8], t[8];
+    for (int kx = 0; kx < PS; kx++) {
+        if (DISPLAY_ROTATE == 90) {
+            // panel (px, py) = surface (py, PW-1-px): panel row py is surface
+            // column py, panel byte kx is surface rows PW-1-8kx downwards
+            for (int i = 0; i < 8; i++)
+                a[i] = surface[(PW - 1 - 8 * kx - i) * SS + (first >> 3)];
+            transpose8(a, t);
+            for (int j = 0; j < 8; j++) band_[j][kx] = t[j];
+        } else {
+            // panel (px, py) = surface (PH-1-py, px): panel rows first..+7 are
+            // surface columns PH-1-first down to PH-8-first
+            int x = PH - 8 - first;
+            for (int i = 0; i < 8; i++)
+                a[i] = bits8(surface + (8 * kx + i) * SS, x);
+            transpose8(a, t);
+            for (int j = 0; j < 8; j++) band_[j][kx] = t[7 - j];
+        }
+    }
+    band_at_ = first;
+}
+
+const uint8_t *rotateRow(const uint8_t *surface, uint16_t row, bool first) {
+    // A new pass may follow a redraw, so its first band is always rebuilt
+    int at = row & ~7;
+    if (first || at != band_at_) buildBand(surface, at);
+    return band_[row & 7];
+}
+
+PanelRect rotateRect(uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1) {
+    PanelRect r;
+    if (DISPLAY_ROTATE == 90) {
+        r = { (uint16_t)(PW - y1), x0, (uint16_t)(PW - y0), x1 };
+    } else if (DISPLAY_ROTATE == 270) {
+        r = { y0, (uint16_t)(PH - x1), y1, (uint16_t)(PH - x0) };
+    } else {
+        r = { x0, y0, x1, y1 };
+    }
+    const uint16_t a = PanelInfo::WINDOW_X_ALIGN;
+    r.x0 -= r.x0 % a;
+    r.x1 = (uint16_t)((r.x1 + a - 1) / a * a);
+    if (r.x1 > PW) r.x1 = PW;
+    return r;
+}
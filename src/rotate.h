@@ -0,0 +1,25 @@
+#pragma once
+// Portrait surfaces pushed to a landscape panel (DISPLAY_ROTATE, panel.h).
+//
+// The firmware draws on an unrotated SurfaceInfo-sized buffer, so GUI_Paint
+// keeps its byte-wise fast paths and never remaps a pixel. The turn to panel
+// order happens as the driver pulls rows: each band of eight panel rows is
+// built from one byte column of the surface, 8x8 bits at a time with a
+// bit-matrix transpose, and served row by row from a small band buffer.
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "panel.h"
+
+#define ROTATE_STATIC_RAM (8 * PanelInfo::STRIDE)   // one band of panel rows
+
+// EPD_RowSource for the driver: panel row `row` of the surface `surface`
+const uint8_t *rotateRow(const uint8_t *surface, uint16_t row, bool first);
+
+// Surface rectangle (end-exclusive) to the panel rectangle that shows it,
+// widened to the panel's window alignment
+struct PanelRect {
+    uint16_t x0, y0, x1, y1;
+};
+PanelRect rotateRect(uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1);
@@ -0,0 +1,54 @@
+#pragma once
+// Bump allocator for short-lived render and message buffers.
+// Memory comes from a fixed static block and is reclaimed wholesale when the
+// enclosing ScratchScope ends (one per rendered frame / handled message), so
+// transient memory is bounded, measurable and off the task stack.
+
+#include <stddef.h>
+#include <stdint.h>
+
+class ScratchArena {
+public:
+    ScratchArena(uint8_t *mem, size_t size) : mem_(mem), size_(size) {}
+
+    // Returns nullptr when the block is exhausted; callers drop the work.
+    void *alloc(size_t n, size_t align = 4) {
+        size_t start = (used_ + align - 1) & ~(align - 1);
+        if (start + n > size_) {
+            failures_++;
+            return nullptr;
+        }
+        used_ = start + n;
+        if (used_ > high_water_) high_water_ = used_;
+        return mem_ + start;
+    }
+
+    char *str(size_t n) { return (char *)alloc(n, 1); }
+
+    size_t   mark() const       { return used_; }
+    void     release(size_t m)  { used_ = m; }
+    size_t   highWater() const  { return high_water_; }
+    size_t   capacity() const   { return size_; }
+    uint32_t failures() const   { return failures_; }
+
+private:
+    uint8_t *mem_;
+    size_t   size_;
+    size_t   used_       = 0;
+    size_t   high_water_ = 0;
+    uint32_t failures_   = 0;
+};
+
+// Everything allocated while a scope is alive is released when it ends.
+// Scopes nest, so a message handled mid-frame cannot free the frame's buffers.
+class ScratchScope {
+public:
+    explicit ScratchScope(ScratchArena &arena) : arena_(arena), mark_(arena.mark()) {}
+    ~ScratchScope() { arena_.release(mark_); }
+    ScratchScope(const ScratchScope &) = delete;
+    ScratchScope &operator=(const ScratchScope &) = delete;
+
+private:
+    ScratchArena &arena_;
+    size_t        mark_;
+};
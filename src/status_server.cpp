@@ -0,0 +1,156 @@
+#include "status_server.h"
+
+#include <errno.h>
+#include <lwip/sockets.h>
+
+#define STATUS_SEND_TIMEOUT_MS 10000
+
+static size_t clampLen(size_t a, size_t b) { return a < b ? a : b; }
+
+void StatusServer::begin() {
+    server_.begin();
+    server_.setNoDelay(true);
+    refill_at_ = millis();
+    Serial.printf("HTTP: status server on :%d\n", STATUS_PORT);
+}
+
+bool StatusServer::takeToken() {
+    unsigned long now = millis();
+    tokens_ += (now - refill_at_) * (STATUS_RATE_PER_MIN / 60000.0f);
+    if (tokens_ > STATUS_RATE_BURST) tokens_ = STATUS_RATE_BURST;
+    refill_at_ = now;
+    if (tokens_ < 1.0f) return false;
+    tokens_ -= 1.0f;
+    return true;
+}
+
+void StatusServer::start(int code, const char *type, size_t len) {
+    const char *reason = code == 200 ? "OK" : code == 404 ? "Not Found" :
+                         code == 405 ? "Method Not Allowed" : "Too Many Requests";
+    head_len_ = snprintf(head_, sizeof(head_),
+                         "HTTP/1.0 %d %s\r\nContent-Type: %s\r\nContent-Length: %u\r\n"
+                         "Cache-Control: no-store\r\nConnection: close\r\n\r\n",
+                         code, reason, type, (unsigned)len);
+    head_pos_ = 0;
+    body_pos_ = 0;
+    since_    = millis();
+    state_    = SENDING;
+}
+
+void StatusServer::route() {
+    body_kind_ = BODY_TEXT;
+    body_len_  = 0;
+
+    if (!takeToken()) {
+        limited_++;
+        body_len_ = snprintf(body_, sizeof(body_), "rate limited\n");
+        start(429, "text/plain", body_len_);
+        return;
+    }
+    if (strncmp(req_, "GET ", 4) != 0) {
+        body_len_ = snprintf(body_, sizeof(body_), "GET only\n");
+        start(405, "text/plain", body_len_);
+        return;
+    }
+    const char *path = req_ + 4;
+    size_t plen = strcspn(path, " ?");
+
+    if (plen == 12 && strncmp(path, "/status.json", plen) == 0) {
+        body_len_ = status_(body_, sizeof(body_));
+        start(200, "application/json", body_len_);
+    } else if (plen == 8 && strncmp(path, "/metrics", plen) == 0) {
+        body_len_ = metrics_(body_, sizeof(body_));
+        start(200, "text/plain; version=0.0.4", body_len_);
+    } else if (plen == 10 && strncmp(path, "/frame.pbm", plen) == 0) {
+        // PBM header rides in head_, the pixels come straight from fb_
+        char pbm[24];
+        int pbm_len = snprintf(pbm, sizeof(pbm), "P4\n%u %u\n", w_, h_);
+        body_kind_ = BODY_FRAME;
+        frame_     = *fb_;
+        body_len_  = (size_t)((w_ + 7) / 8) * h_;
+        start(200, "image/x-portable-bitmap", pbm_len + body_len_);
+        head_len_ += snprintf(head_ + head_len_, sizeof(head_) - head_len_, "%s", pbm);
+    } else {
+        body_len_ = snprintf(body_, sizeof(body_), "try /status.json /metrics /frame.pbm\n");
+        start(404, "text/plain", body_len_);
+    }
+}
+
+// WiFiClient::write() retries a full send buffer for up to its socket
+// timeout; a non-blocking send() hands back only what fits right now.
+// Returns the bytes queued, 0 if none fit, -1 if the connection is gone.
+int StatusServer::sendNow(const uint8_t *buf, size_t n) {
+    int sent = send(client_.fd(), buf, n, MSG_DONTWAIT);
+    if (sent >= 0) return sent;
+    return errno == EAGAIN || errno == EWOULDBLOCK ? 0 : -1;
+}
+
+void StatusServer::finish() {
+    // Unread request bytes would make lwIP answer the close with a RST
+    while (client_.available() > 0) client_.read();
+    client_.stop();
+    state_ = IDLE;
+}
+
+void StatusServer::poll() {
+    unsigned long t0 = micros();
+
+    if (state_ == IDLE) {
+        client_ = server_.accept();
+        if (!client_) return;
+        state_   = READING;
+        since_   = millis();
+        req_len_ = 0;
+    }
+
+    if (state_ == READING) {
+        while (client_.available() > 0) {
+            int c = client_.read();
+            if (c == '\r' || c == '\n' || req_len_ == sizeof(req_) - 1) {
+                req_[req_len_] = '\0';
+                route();
+                break;
+            }
+            req_[req_len_++] = (char)c;
+        }
+        if (state_ == READING && (millis() - since_ > STATUS_REQ_TIMEOUT_MS || !client_.connected()))
+            finish();
+        return;   // response goes out from the next poll
+    }
+
+    // SENDING
+    while (client_.available() > 0) client_.read();   // rest of the request headers
+    size_t budget = STATUS_POLL_BYTES;
+    while (budget > 0 && micros() - t0 < STATUS_POLL_BUDGET_US) {
+        int n;
+        if (head_pos_ < head_len_) {
+            n = sendNow((const uint8_t *)head_ + head_pos_, clampLen(head_len_ - head_pos_, budget));
+            if (n > 0) head_pos_ += n;
+        } else if (body_pos_ < body_len_) {
+            size_t want = clampLen(body_len_ - body_pos_, budget);
+            if (body_kind_ == BODY_FRAME) {
+                // Framebuffer is 1 = white, PBM is 1 = black; a short send
+                // re-inverts the unsent tail next time
+                want = clampLen(want, sizeof(body_));
+                for (size_t i = 0; i < want; i++) body_[i] = ~frame_[body_pos_ + i];
+                n = sendNow((const uint8_t *)body_, want);
+            } else {
+                n = sendNow((const uint8_t *)body_ + body_pos_, want);
+            }
+            if (n > 0) body_pos_ += n;
+        } else {
+            served_++;
+            finish();
+            return;
+        }
+        if (n < 0) {   // reset or closed by the peer
+            finish();
+            return;
+        }
+        if (n == 0) {   // send buffer full; try again next poll
+            if (millis() - since_ > STATUS_SEND_TIMEOUT_MS) finish();
+            return;
+        }
+        budget -= n;
+    }
+}
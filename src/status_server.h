@@ -0,0 +1,74 @@
+#pragma once
+// Minimal HTTP/1.0 status server for field techs and monitoring.
+//
+//   GET /status.json   device state (JSON)
+//   GET /metrics       Prometheus text format
+//   GET /frame.pbm     the current framebuffer as a binary PBM, streamed
+//                      straight from the buffer (bytes inverted on the way);
+//                      a screen change mid-download can tear it
+//
+// One connection at a time, driven from poll(): each call does at most
+// STATUS_POLL_BYTES of socket I/O and STATUS_POLL_BUDGET_US of work, and
+// sends never wait on a full socket buffer, so a slow or hostile client
+// can't hold up rendering or MQTT. Requests beyond
+// STATUS_RATE_PER_MIN (burst STATUS_RATE_BURST) get a 429.
+// Unauthenticated, read-only, LAN only.
+
+#include <Arduino.h>
+#include <WiFi.h>
+
+#define STATUS_PORT            80
+#define STATUS_BODY_MAX        1536
+#define STATUS_POLL_BYTES      1460    // one TCP segment per poll
+#define STATUS_POLL_BUDGET_US  3000
+#define STATUS_REQ_TIMEOUT_MS  2000
+#define STATUS_RATE_PER_MIN    30
+#define STATUS_RATE_BURST      5
+
+class StatusServer {
+public:
+    // Fill `out` (STATUS_BODY_MAX bytes) and return the length
+    typedef size_t (*BodyFn)(char *out, size_t out_sz);
+
+    // `fb` points at the front-buffer pointer, which moves on every swap
+    StatusServer(BodyFn status, BodyFn metrics, const uint8_t *const *fb, uint16_t w, uint16_t h)
+        : server_(STATUS_PORT), status_(status), metrics_(metrics), fb_(fb), w_(w), h_(h) {}
+
+    void begin();
+    void poll();
+
+    uint32_t served() const { return served_; }
+    uint32_t limited() const { return limited_; }
+
+private:
+    enum State : uint8_t { IDLE, READING, SENDING };
+    enum Body : uint8_t { BODY_TEXT, BODY_FRAME };
+
+    void start(int code, const char *type, size_t len);
+    void route();
+    int  sendNow(const uint8_t *buf, size_t n);
+    void finish();
+    bool takeToken();
+
+    WiFiServer     server_;
+    WiFiClient     client_;
+    BodyFn         status_, metrics_;
+    const uint8_t *const *fb_;
+    const uint8_t *frame_ = nullptr;   // front buffer when the download started
+    uint16_t       w_, h_;
+
+    State          state_ = IDLE;
+    Body           body_kind_ = BODY_TEXT;
+    unsigned long  since_ = 0;
+    char           req_[64];
+    uint8_t        req_len_ = 0;
+
+    char           head_[160];
+    size_t         head_len_ = 0, head_pos_ = 0;
+    char           body_[STATUS_BODY_MAX];
+    size_t         body_len_ = 0, body_pos_ = 0;
+
+    float          tokens_ = STATUS_RATE_BURST;
+    unsigned long  refill_at_ = 0;
+    uint32_t       served_ = 0, limited_ = 0;
+};
@@ -0,0 +1,91 @@
+#pragma once
+// Allocation-free value formatting for the render path.
+// Appends into a caller buffer (usually a scratch LINE_BUF), always
+// NUL-terminated and silently truncated, without touching newlib's printf:
+// no float printf, no va_list frame, a few dozen bytes of stack.
+//
+//     TextBuf(buf, LINE_BUF).str("CO2  ").fixed(sensor.co2, 0).str("  ppm");
+//
+// fixed() rounds half away from zero in fixed point; printf's "%.1f" rounds
+// the exact binary value, so the two can differ on a true tie (22.25).
+
+#include <math.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#define TEXT_MAX_DECIMALS 4
+
+class TextBuf {
+public:
+    TextBuf(char *buf, size_t cap) : buf_(buf), cap_(cap) {
+        if (cap_) buf_[0] = '\0';
+    }
+
+    TextBuf &chr(char c) {
+        if (len_ + 1 < cap_) {
+            buf_[len_++] = c;
+            buf_[len_] = '\0';
+        }
+        return *this;
+    }
+
+    // At most `max` characters of `s`, like "%.*s"
+    TextBuf &str(const char *s, size_t max = (size_t)-1) {
+        while (s && *s && max--) chr(*s++);
+        return *this;
+    }
+
+    // Right-aligned in `width`; pad '0' goes after the sign like "%05d"
+    TextBuf &num(int32_t v, uint8_t width = 0, char pad = ' ') {
+        return digits(v < 0, v < 0 ? 0u - (uint32_t)v : (uint32_t)v, 0, width, pad);
+    }
+
+    // `scaled` is the value times 10^decimals: fixedScaled(215, 1) -> "21.5"
+    TextBuf &fixedScaled(int32_t scaled, uint8_t decimals, uint8_t width = 0) {
+        if (decimals > TEXT_MAX_DECIMALS) decimals = TEXT_MAX_DECIMALS;
+        return digits(scaled < 0, scaled < 0 ? 0u - (uint32_t)scaled : (uint32_t)scaled,
+                      decimals, width, ' ');
+    }
+
+    // Float in, fixed point out; only a multiply and a truncation touch the float
+    TextBuf &fixed(float v, uint8_t decimals, uint8_t width = 0) {
+        if (isnan(v)) return str("nan");
+        if (decimals > TEXT_MAX_DECIMALS) decimals = TEXT_MAX_DECIMALS;
+        static const float scale[] = { 1.0f, 10.0f, 100.0f, 1000.0f, 10000.0f };
+        float s = v * scale[decimals];
+        if (!(s < 2147483520.0f && s > -2147483520.0f))   // also catches inf
+            return str(isinf(v) ? (v < 0 ? "-inf" : "inf") : "ovf");
+        // Values that round to zero print unsigned, unlike printf's "-0.0"
+        return fixedScaled((int32_t)(s + (s < 0 ? -0.5f : 0.5f)), decimals, width);
+    }
+
+    const char *c_str() const { return cap_ ? buf_ : ""; }
+    size_t      len() const   { return len_; }
+    operator const char *() const { return c_str(); }
+
+private:
+    TextBuf &digits(bool neg, uint32_t mag, uint8_t decimals, uint8_t width, char pad) {
+        char tmp[12];   // 10 digits + point, sign goes straight out
+        int n = 0;
+        do {
+            if (n == decimals && decimals) tmp[n++] = '.';
+            tmp[n++] = (char)('0' + mag % 10);
+            mag /= 10;
+        } while (mag || n <= decimals);
+
+        int used = n + (neg ? 1 : 0);
+        if (pad == '0') {
+            if (neg) chr('-');
+            for (; used < width; used++) chr('0');
+        } else {
+            for (; used < width; used++) chr(pad);
+            if (neg) chr('-');
+        }
+        while (n) chr(tmp[--n]);
+        return *this;
+    }
+
+    char  *buf_;
+    size_t cap_;
+    size_t len_ = 0;
+};
@@ -0,0 +1,226 @@
+#include "tls_client.h"
+
+#include <esp_random.h>
+#include <mbedtls/error.h>
+#include <mbedtls/net_sockets.h>
+
+// ─── mbedTLS glue ─────────────────────────────────────────────
+
+int TlsClient::bioSend(void *ctx, const unsigned char *buf, size_t len) {
+    WiFiClient *tcp = static_cast<WiFiClient *>(ctx);
+    size_t n = tcp->write(buf, len);
+    if (n > 0) return (int)n;
+    return tcp->connected() ? MBEDTLS_ERR_SSL_WANT_WRITE : MBEDTLS_ERR_NET_CONN_RESET;
+}
+
+int TlsClient::bioRecv(void *ctx, unsigned char *buf, size_t len) {
+    WiFiClient *tcp = static_cast<WiFiClient *>(ctx);
+    if (tcp->available() <= 0)
+        return tcp->connected() ? MBEDTLS_ERR_SSL_WANT_READ : MBEDTLS_ERR_NET_CONN_RESET;
+    int n = tcp->read(buf, len);
+    return n > 0 ? n : MBEDTLS_ERR_SSL_WANT_READ;
+}
+
+// Hardware RNG is a true RNG while the radio is on, which it is whenever
+// we have a socket; saves the ctr_drbg state
+int TlsClient::rng(void *, unsigned char *buf, size_t len) {
+    esp_fill_random(buf, len);
+    return 0;
+}
+
+bool TlsClient::begin() {
+    if (ready_) return true;
+    unsigned long start = millis();
+    uint32_t heap = ESP.getFreeHeap();
+
+    mbedtls_x509_crt_init(&ca_);
+    mbedtls_ssl_config_init(&conf_);
+    mbedtls_ssl_init(&ssl_);
+    mbedtls_ssl_session_init(&session_);
+
+    int rc = mbedtls_x509_crt_parse(&ca_, (const unsigned char *)ca_pem_, strlen(ca_pem_) + 1);
+    if (rc != 0) {
+        Serial.printf("TLS: CA parse failed (-0x%04x)\n", -rc);
+        return false;
+    }
+    rc = mbedtls_ssl_config_defaults(&conf_, MBEDTLS_SSL_IS_CLIENT,
+                                     MBEDTLS_SSL_TRANSPORT_STREAM, MBEDTLS_SSL_PRESET_DEFAULT);
+    if (rc != 0) return false;
+    mbedtls_ssl_conf_authmode(&conf_, MBEDTLS_SSL_VERIFY_REQUIRED);
+    mbedtls_ssl_conf_ca_chain(&conf_, &ca_, nullptr);
+    mbedtls_ssl_conf_rng(&conf_, rng, nullptr);
+    mbedtls_ssl_conf_max_tls_version(&conf_, MBEDTLS_SSL_VERSION_TLS1_2);
+#if defined(MBEDTLS_SSL_MAX_FRAGMENT_LENGTH)
+    mbedtls_ssl_conf_max_frag_len(&conf_, TLS_MAX_FRAG);
+#endif
+#if defined(MBEDTLS_SSL_SESSION_TICKETS)
+    mbedtls_ssl_conf_session_tickets(&conf_, MBEDTLS_SSL_SESSION_TICKETS_ENABLED);
+#endif
+
+    rc = mbedtls_ssl_setup(&ssl_, &conf_);
+    if (rc != 0) {
+        Serial.printf("TLS: ssl_setup failed (-0x%04x)\n", -rc);
+        return false;
+    }
+    mbedtls_ssl_set_bio(&ssl_, &tcp_, bioSend, bioRecv, nullptr);
+
+    ready_ = true;
+    Serial.printf("TLS: ready in %lums, %ld bytes heap for CA + context\n",
+                  millis() - start, (long)heap - (long)ESP.getFreeHeap());
+    return true;
+}
+
+void TlsClient::dropSession() {
+    mbedtls_ssl_session_free(&session_);
+    mbedtls_ssl_session_init(&session_);
+    have_session_ = false;
+}
+
+int TlsClient::handshake(const char *host) {
+    mbedtls_ssl_session_reset(&ssl_);   // keeps buffers, config and CA
+    mbedtls_ssl_set_hostname(&ssl_, host);
+
+    unsigned char offered_id[32];
+    size_t offered_len = 0;
+    resume_offered_ = false;
+    if (have_session_ && millis() - session_at_ > TLS_SESSION_MAX_AGE_MS)
+        dropSession();
+    if (have_session_ && mbedtls_ssl_set_session(&ssl_, &session_) == 0) {
+        resume_offered_ = true;
+        offered_len = mbedtls_ssl_session_get_id_len(&session_);
+        memcpy(offered_id, mbedtls_ssl_session_get_id(&session_), offered_len);
+    }
+
+    unsigned long start = millis();
+    int rc;
+    while ((rc = mbedtls_ssl_handshake(&ssl_)) != 0) {
+        if (rc != MBEDTLS_ERR_SSL_WANT_READ && rc != MBEDTLS_ERR_SSL_WANT_WRITE) break;
+        if (millis() - start > TLS_HANDSHAKE_TIMEOUT_MS) {
+            rc = MBEDTLS_ERR_SSL_TIMEOUT;
+            break;
+        }
+        delay(1);
+    }
+    handshake_ms_ = millis() - start;
+
+    if (rc != 0) {
+        char err[64];
+        mbedtls_strerror(rc, err, sizeof(err));
+        Serial.printf("TLS: handshake failed after %lums: %s\n", handshake_ms_, err);
+        uint32_t flags = mbedtls_ssl_get_verify_result(&ssl_);
+        if (flags && flags != (uint32_t)-1) {
+            char info[128];
+            mbedtls_x509_crt_verify_info(info, sizeof(info), "  ", flags);
+            Serial.print(info);
+        }
+        dropSession();   // a rejected session must not be offered again
+        return rc;
+    }
+
+    // Server echoes the offered session id only when it resumes
+    dropSession();
+    have_session_ = mbedtls_ssl_get_session(&ssl_, &session_) == 0;
+    session_at_ = millis();
+    bool resumed = resume_offered_ && offered_len > 0 &&
+                   mbedtls_ssl_session_get_id_len(&session_) == offered_len &&
+                   memcmp(mbedtls_ssl_session_get_id(&session_), offered_id, offered_len) == 0;
+    if (resumed) resumed_++;
+    else full_++;
+    Serial.printf("TLS: %s handshake in %lums (%s)\n", resumed ? "resumed" : "full",
+                  handshake_ms_, mbedtls_ssl_get_ciphersuite(&ssl_));
+    return 0;
+}
+
+// ─── Client interface ─────────────────────────────────────────
+
+int TlsClient::connect(const char *host, uint16_t port) {
+    if (!ready_ && !begin()) return 0;
+    stop();
+    if (!tcp_.connect(host, port)) return 0;
+    tcp_.setNoDelay(true);
+    if (handshake(host) != 0) {
+        tcp_.stop();
+        return 0;
+    }
+    open_ = true;
+    return 1;
+}
+
+int TlsClient::connect(IPAddress ip, uint16_t port) {
+    String host = ip.toString();
+    return connect(host.c_str(), port);
+}
+
+size_t TlsClient::write(const uint8_t *buf, size_t size) {
+    if (!open_) return 0;
+    size_t done = 0;
+    unsigned long start = millis();
+    while (done < size) {
+        int rc = mbedtls_ssl_write(&ssl_, buf + done, size - done);
+        if (rc > 0) {
+            done += rc;
+            continue;
+        }
+        if ((rc != MBEDTLS_ERR_SSL_WANT_WRITE && rc != MBEDTLS_ERR_SSL_WANT_READ) ||
+            millis() - start > TLS_HANDSHAKE_TIMEOUT_MS) {
+            stop();
+            break;
+        }
+        delay(1);
+    }
+    return done;
+}
+
+int TlsClient::available() {
+    if (!open_) return 0;
+    int pending = (peeked_ >= 0) + (int)mbedtls_ssl_get_bytes_avail(&ssl_);
+    if (pending) return pending;
+
+    // Pull the next record off the socket, if any, without blocking
+    int rc = mbedtls_ssl_read(&ssl_, nullptr, 0);
+    if (rc < 0 && rc != MBEDTLS_ERR_SSL_WANT_READ && rc != MBEDTLS_ERR_SSL_WANT_WRITE) {
+        if (rc == MBEDTLS_ERR_SSL_PEER_CLOSE_NOTIFY || rc == MBEDTLS_ERR_NET_CONN_RESET) stop();
+        return 0;
+    }
+    return (int)mbedtls_ssl_get_bytes_avail(&ssl_);
+}
+
+int TlsClient::read(uint8_t *buf, size_t size) {
+    if (!open_ || size == 0) return -1;
+    size_t n = 0;
+    if (peeked_ >= 0) {
+        buf[n++] = (uint8_t)peeked_;
+        peeked_ = -1;
+        if (n == size) return n;
+    }
+    int rc = mbedtls_ssl_read(&ssl_, buf + n, size - n);
+    if (rc > 0) return n + rc;
+    if (rc == MBEDTLS_ERR_SSL_PEER_CLOSE_NOTIFY || rc == MBEDTLS_ERR_NET_CONN_RESET ||
+        (rc == 0 && n == 0)) stop();
+    return n > 0 ? (int)n : -1;
+}
+
+int TlsClient::read() {
+    uint8_t b;
+    return read(&b, 1) == 1 ? b : -1;
+}
+
+int TlsClient::peek() {
+    if (peeked_ < 0) peeked_ = read();
+    return peeked_;
+}
+
+void TlsClient::stop() {
+    if (open_) mbedtls_ssl_close_notify(&ssl_);
+    open_ = false;
+    peeked_ = -1;
+    tcp_.stop();
+    // The cached session survives: it is what makes the next connect fast
+}
+
+uint8_t TlsClient::connected() {
+    if (!open_) return 0;
+    if (tcp_.connected() || mbedtls_ssl_get_bytes_avail(&ssl_) > 0 || peeked_ >= 0) return 1;
+    open_ = false;
+    return 0;
+}
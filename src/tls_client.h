@@ -0,0 +1,74 @@
+#pragma once
+// MQTT-over-TLS transport on mbedTLS, built for fast reconnects on the C6.
+//
+//  - The CA chain is parsed once in begin() and shared by every connection.
+//  - The SSL context is set up once and only reset between connections, so
+//    its record buffers are allocated one time instead of per handshake.
+//    The max_fragment_length extension caps records at TLS_MAX_FRAG; with
+//    CONFIG_MBEDTLS_DYNAMIC_BUFFER the buffers shrink to match.
+//  - After a full handshake the session (id or ticket) is kept; a reconnect
+//    within TLS_SESSION_MAX_AGE_MS offers it and the broker can resume with
+//    an abbreviated handshake (no certificate exchange, no key agreement).
+//  - TLS 1.2 is pinned, since that is where id/ticket resumption works the
+//    same on mosquitto and EMQX.
+
+#include <Arduino.h>
+#include <Client.h>
+#include <WiFi.h>
+
+#include <mbedtls/ssl.h>
+#include <mbedtls/x509_crt.h>
+
+#define TLS_HANDSHAKE_TIMEOUT_MS 10000
+#define TLS_SESSION_MAX_AGE_MS   (6UL * 3600 * 1000)
+#define TLS_MAX_FRAG             MBEDTLS_SSL_MAX_FRAG_LEN_4096   // matches MQTT_BUFFER_SIZE
+
+class TlsClient : public Client {
+public:
+    explicit TlsClient(const char *ca_pem) : ca_pem_(ca_pem) {}
+
+    bool begin();   // parse CA, configure mbedTLS; call once before connecting
+
+    int connect(IPAddress ip, uint16_t port) override;
+    int connect(const char *host, uint16_t port) override;
+    size_t write(uint8_t b) override { return write(&b, 1); }
+    size_t write(const uint8_t *buf, size_t size) override;
+    int available() override;
+    int read() override;
+    int read(uint8_t *buf, size_t size) override;
+    int peek() override;
+    void flush() override {}
+    void stop() override;
+    uint8_t connected() override;
+    operator bool() override { return connected(); }
+
+    // Stats from the last handshake
+    bool          lastResumeOffered() const { return resume_offered_; }
+    unsigned long lastHandshakeMs() const { return handshake_ms_; }
+    uint32_t      fullHandshakes() const { return full_; }
+    uint32_t      resumedHandshakes() const { return resumed_; }
+
+private:
+    static int bioSend(void *ctx, const unsigned char *buf, size_t len);
+    static int bioRecv(void *ctx, unsigned char *buf, size_t len);
+    static int rng(void *ctx, unsigned char *buf, size_t len);
+
+    int handshake(const char *host);
+    void dropSession();
+
+    const char          *ca_pem_;
+    WiFiClient           tcp_;
+    mbedtls_x509_crt     ca_;
+    mbedtls_ssl_config   conf_;
+    mbedtls_ssl_context  ssl_;
+    mbedtls_ssl_session  session_;
+    bool                 ready_ = false;       // begin() succeeded
+    bool                 open_ = false;        // handshake done, not stopped
+    bool                 have_session_ = false;
+    unsigned long        session_at_ = 0;
+    int                  peeked_ = -1;
+
+    bool                 resume_offered_ = false;
+    unsigned long        handshake_ms_ = 0;
+    uint32_t             full_ = 0, resumed_ = 0;
+};
@@ -0,0 +1,128 @@
+#include "topics.h"
+
+#include <stdio.h>
+#include <string.h>
+
+namespace {
+
+enum Scope : uint8_t { DEV, ABS, DISC };
+
+#define NOSUB -1
+#define Q0     0
+#define Q1     1
+
+struct Entry {
+    Scope       scope;
+    const char *path;
+    int8_t      sub;
+};
+
+#define TOPIC_ENTRY(id, scope, path, sub) { scope, path, sub },
+const Entry entries[TOPIC_COUNT] = { TOPIC_TABLE(TOPIC_ENTRY) };
+#undef TOPIC_ENTRY
+
+struct Sensor {
+    TopicId     topic, state;
+    const char *name, *dev_class, *unit;
+};
+
+const Sensor sensors[DISCOVERY_COUNT] = {
+    { TOPIC_DISC_CO2,  TOPIC_CO2,  "CO2",         "carbon_dioxide", "ppm" },
+    { TOPIC_DISC_TEMP, TOPIC_TEMP, "Temperature", "temperature",    "°C" },
+    { TOPIC_DISC_HUM,  TOPIC_HUM,  "Humidity",    "humidity",       "%" },
+};
+
+char      arena[TOPIC_ARENA_SIZE];
+size_t    used = 0;
+uint16_t  offsets[TOPIC_COUNT];
+uint8_t   lengths[TOPIC_COUNT];
+Discovery disc[DISCOVERY_COUNT];
+
+// Concatenates the pieces into the arena; nullptr when full
+char *intern(const char *a, const char *b, const char *c, const char *d, size_t *len_out) {
+    const char *parts[] = { a, b, c, d };
+    size_t len = 0;
+    for (const char *part : parts) len += strlen(part);
+    if (used + len + 1 > sizeof(arena)) return nullptr;
+    char *p = arena + used;
+    for (const char *part : parts) {
+        size_t l = strlen(part);
+        memcpy(arena + used, part, l);
+        used += l;
+    }
+    arena[used++] = '\0';
+    *len_out = len;
+    return p;
+}
+
+}  // namespace
+
+bool topicsInit(const char *device_id) {
+    used = 0;
+    arena[used++] = '\0';   // offset 0 is the empty string for anything that didn't fit
+
+    char uid[32];
+    size_t n = 0;
+    for (; device_id[n] && n < sizeof(uid) - 1; n++)
+        uid[n] = device_id[n] == '-' ? '_' : device_id[n];
+    uid[n] = '\0';
+
+    bool ok = true;
+    for (int i = 0; i < TOPIC_COUNT; i++) {
+        const Entry &e = entries[i];
+        size_t len = 0;
+        char *p;
+        switch (e.scope) {
+            case DEV:  p = intern(device_id, e.path, "", "", &len); break;
+            case ABS:  p = intern(e.path, "", "", "", &len); break;
+            default:   p = intern("homeassistant/sensor/", uid, e.path, "/config", &len); break;
+        }
+        offsets[i] = p ? (uint16_t)(p - arena) : 0;
+        lengths[i] = p ? (uint8_t)len : 0;
+        ok &= p != nullptr;
+    }
+
+    // Discovery payloads are fixed for the life of the firmware, so build
+    // them here too rather than on every connect
+    for (int i = 0; i < DISCOVERY_COUNT; i++) {
+        const Sensor &s = sensors[i];
+        char *p = arena + used;
+        size_t room = sizeof(arena) - used;
+        int len = snprintf(p, room,
+            "{\"name\":\"%s\","
+            "\"device_class\":\"%s\","
+            "\"state_topic\":\"%s\","
+            "\"unit_of_measurement\":\"%s\","
+            "\"unique_id\":\"%s%s\","
+            "\"device\":{\"identifiers\":[\"%s\"],"
+            "\"name\":\"Torii Ink\",\"model\":\"ESP32-C6 e-ink\","
+            "\"manufacturer\":\"Hiki\"}}",
+            s.name, s.dev_class, topic(s.state), s.unit,
+            uid, entries[s.topic].path, uid);
+        bool fits = len > 0 && (size_t)len < room;
+        disc[i] = { s.topic, s.state, fits ? p : arena };
+        if (fits) used += len + 1;
+        ok &= fits;
+    }
+    return ok;
+}
+
+const char *topic(TopicId id) {
+    return id < TOPIC_COUNT ? arena + offsets[id] : arena;
+}
+
+int topicSubQos(TopicId id) {
+    return id < TOPIC_COUNT ? entries[id].sub : NOSUB;
+}
+
+TopicId topicMatch(const char *s) {
+    size_t len = strlen(s);
+    for (int i = 0; i < TOPIC_COUNT; i++)
+        if (entries[i].sub != NOSUB && lengths[i] == len && memcmp(arena + offsets[i], s, len) == 0)
+            return (TopicId)i;
+    return TOPIC_COUNT;
+}
+
+const Discovery &discovery(int i) {
+    return disc[i];
+}
@@ -0,0 +1,65 @@
+#pragma once
+// MQTT topic table. Every topic the firmware publishes or subscribes to is
+// listed once below and interned into a fixed arena by topicsInit() with
+// the runtime device id, so publish/subscribe sites pass a ready string
+// (topic(TOPIC_CO2)) and never format one.
+//
+// Scopes:  DEV   <device_id><path>
+//          ABS   <path>                      shared gateway topics
+//          DISC  homeassistant/sensor/<uid><path>/config
+// where <uid> is the device id with '-' turned into '_'.
+//
+// sub: NOSUB, or the QoS to subscribe with. State topics use QoS 1 so the
+// persistent session queues them while we're offline; live streams
+// (frames, draw lists, OTA chunks) stay at QoS 0, since a queued backlog
+// of those is stale by the time it arrives.
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define TOPIC_ARENA_SIZE 3072   // topics + HA discovery payloads for a 31-char id
+
+//  X(id,                 scope, path,                sub)
+#define TOPIC_TABLE(X) \
+    X(TOPIC_CO2,          DEV,  "/sensor/co2",         NOSUB) \
+    X(TOPIC_TEMP,         DEV,  "/sensor/temperature", NOSUB) \
+    X(TOPIC_HUM,          DEV,  "/sensor/humidity",    NOSUB) \
+    X(TOPIC_RADIO,        DEV,  "/telemetry/radio",    NOSUB) \
+    X(TOPIC_LATENCY,      DEV,  "/telemetry/latency",  NOSUB) \
+    X(TOPIC_FRAME,        DEV,  "/frame",              Q0)    \
+    X(TOPIC_FRAME_ACK,    DEV,  "/frame/ack",          NOSUB) \
+    X(TOPIC_DRAW,         DEV,  "/draw",               Q0)    \
+    X(TOPIC_OTA,          DEV,  "/ota",                Q1)    \
+    X(TOPIC_OTA_CHUNK,    DEV,  "/ota/chunk",          Q0)    \
+    X(TOPIC_OTA_STATUS,   DEV,  "/ota/status",         NOSUB) \
+    X(TOPIC_CONFIG,       DEV,  "/config",             Q1)    \
+    X(TOPIC_CONFIG_STATE, DEV,  "/config/state",       NOSUB) \
+    X(TOPIC_HEALTH,       ABS,  "hiki/health",             Q1) \
+    X(TOPIC_KILLSWITCH,   ABS,  "hiki/killswitch/status",  Q1) \
+    X(TOPIC_GW_HEALTH,    ABS,  "hiki/gateway/health",     Q1) \
+    X(TOPIC_DISC_CO2,     DISC, "_co2",                NOSUB) \
+    X(TOPIC_DISC_TEMP,    DISC, "_temperature",        NOSUB) \
+    X(TOPIC_DISC_HUM,     DISC, "_humidity",           NOSUB)
+
+#define TOPIC_ENUM(id, scope, path, sub) id,
+enum TopicId : uint8_t { TOPIC_TABLE(TOPIC_ENUM) TOPIC_COUNT };
+#undef TOPIC_ENUM
+
+// Home Assistant discovery: one retained config per sensor
+struct Discovery {
+    TopicId topic;      // where the config goes
+    TopicId state;      // the sensor's value topic
+    const char *payload;
+};
+#define DISCOVERY_COUNT 3
+
+// Returns false if the arena overflowed (topics past that point are "")
+bool topicsInit(const char *device_id);
+
+const char *topic(TopicId id);
+int topicSubQos(TopicId id);   // -1 when not subscribed
+
+// Maps an incoming topic back to its id; TOPIC_COUNT when unknown
+TopicId topicMatch(const char *s);
+
+const Discovery &discovery(int i);
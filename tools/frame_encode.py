@@ -0,0 +1,186 @@
+#!/usr/bin/env python3
+"""Encode an image as frame patches for <device>/frame.
+
+Wire format is documented in src/remote_frame.h. Without --base the frame
+goes out as KEY patches; with --base it is an XOR delta cropped to the
+changed bounding box.
+
+Every patch has to fit the device's MQTT buffer (PubSubClient drops larger
+messages without a word). A key frame is split into row bands, all but the
+last flagged DEFER so the panel refreshes once; a delta that would not fit
+is sent as a banded key frame instead. With more than one patch the files
+are numbered (f1-0.bin, f1-1.bin, ...) and must be published in order.
+
+--size is the device's drawing surface (DISPLAY_W x DISPLAY_H), 400x300 on
+the 4.2" panel; a build with a rotated surface needs the turned size.
+
+    ./frame_encode.py dash.png --seq 1 -o f1.bin
+    ./frame_encode.py dash2.png --base dash.png --seq 2 -o f2.bin
+    for f in f1-*.bin; do mosquitto_pub -t torii-ink/frame -f "$f"; done
+    mosquitto_pub -t torii-ink/frame -f f2.bin
+
+Dependencies: Pillow only.
+"""
+
+import argparse
+import struct
+import sys
+from pathlib import Path
+from PIL import Image
+
+FLAG_KEY = 0x01
+FLAG_DEFER = 0x02
+HEADER = "<BBHHHHHH"
+
+# PubSubClient keeps the whole PUBLISH packet in its buffer: fixed header
+# (up to 5), topic length (2), "<device_id>/frame" with device_id up to 31
+# characters, packet id (2)
+MQTT_BUFFER_SIZE = 4096   # src/main.cpp
+PAYLOAD_MAX = MQTT_BUFFER_SIZE - 5 - 2 - (31 + len("/frame")) - 2
+
+
+class Surface:
+    """The device's drawing surface; rows are padded to whole bytes."""
+
+    def __init__(self, w: int, h: int):
+        self.w, self.h = w, h
+        self.stride = (w + 7) // 8
+
+
+def parse_size(text: str) -> Surface:
+    try:
+        w, h = (int(v) for v in text.lower().split("x"))
+    except ValueError:
+        raise argparse.ArgumentTypeError(f"expected WxH, got {text!r}")
+    if w <= 0 or h <= 0:
+        raise argparse.ArgumentTypeError(f"bad surface size {text!r}")
+    return Surface(w, h)
+
+
+def to_bytes(path: Path, surf: Surface) -> bytes:
+    """Packed MSB-first rows, 1=WHITE (framebuffer format)."""
+    img = Image.open(path).convert("L").resize((surf.w, surf.h))
+    out = bytearray(surf.stride * surf.h)
+    px = img.load()
+    for y in range(surf.h):
+        for x in range(surf.w):
+            if px[x, y] >= 128:
+                out[y * surf.stride + x // 8] |= 0x80 >> (x % 8)
+    return bytes(out)
+
+
+def rle(data: bytes) -> bytes:
+    out = bytearray()
+    i, n = 0, len(data)
+    lit = bytearray()
+
+    def flush():
+        while lit:
+            chunk = lit[:128]
+            out.append(len(chunk) - 1)
+            out.extend(chunk)
+            del lit[:128]
+
+    while i < n:
+        run = 1
+        while i + run < n and run < 128 and data[i + run] == data[i]:
+            run += 1
+        if run >= 3:
+            flush()
+            out.append(0x80 | (run - 1))
+            out.append(data[i])
+            i += run
+        else:
+            lit.extend(data[i:i + run])
+            i += run
+    flush()
+    return bytes(out)
+
+
+def changed_box(a: bytes, b: bytes, surf: Surface):
+    s = surf.stride
+    rows = [y for y in range(surf.h) if a[y * s:(y + 1) * s] != b[y * s:(y + 1) * s]]
+    if not rows:
+        return None
+    cols = [c for c in range(s) if any(a[y * s + c] != b[y * s + c] for y in rows)]
+    return cols[0], rows[0], cols[-1] + 1, rows[-1] + 1
+
+
+def patch(flags: int, seq: int, base_seq: int, box, body: bytes) -> bytes:
+    x0, y0, x1, y1 = box
+    hdr = struct.pack(HEADER, ord("F"), flags, seq, base_seq,
+                      x0 * 8, y0, (x1 - x0) * 8, y1 - y0)
+    return hdr + rle(body)
+
+
+def key_bands(new: bytes, surf: Surface, seq: int, limit: int) -> list[bytes]:
+    """Whole frame as KEY patches of as many rows as fit under `limit`."""
+    s = surf.stride
+
+    def band(y0: int, y1: int) -> bytes:
+        return patch(FLAG_KEY | FLAG_DEFER, seq, 0, (0, y0, s, y1), new[y0 * s:y1 * s])
+
+    out = []
+    y = 0
+    while y < surf.h:
+        lo, hi = y + 1, surf.h   # largest end row whose band still fits
+        while lo < hi:
+            mid = (lo + hi + 1) // 2
+            if len(band(y, mid)) <= limit:
+                lo = mid
+            else:
+                hi = mid - 1
+        out.append(bytearray(band(y, lo)))
+        y = lo
+    out[-1][1] &= ~FLAG_DEFER   # the last band triggers the refresh
+    return [bytes(p) for p in out]
+
+
+def encode(new: bytes, base: bytes | None, surf: Surface, seq: int, base_seq: int,
+           limit: int = PAYLOAD_MAX) -> list[bytes]:
+    s = surf.stride
+    if base is not None:
+        box = changed_box(base, new, surf)
+        if box is None:
+            return []
+        x0, y0, x1, y1 = box
+        body = bytes(base[y * s + c] ^ new[y * s + c]
+                     for y in range(y0, y1) for c in range(x0, x1))
+        delta = patch(0, seq, base_seq, box, body)
+        if len(delta) <= limit:
+            return [delta]
+    patches = key_bands(new, surf, seq, limit)
+    for p in patches:
+        if len(p) > limit:
+            raise ValueError(f"patch of {len(p)} bytes exceeds the {limit} byte limit")
+    return patches
+
+
+def main() -> int:
+    ap = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    ap.add_argument("image", type=Path)
+    ap.add_argument("--base", type=Path, help="image currently on the panel")
+    ap.add_argument("--seq", type=int, required=True)
+    ap.add_argument("--base-seq", type=int, help="defaults to seq - 1")
+    ap.add_argument("--size", type=parse_size, default="400x300",
+                    help="device surface, WxH (default 400x300)")
+    ap.add_argument("-o", "--out", type=Path, required=True)
+    args = ap.parse_args()
+
+    base = to_bytes(args.base, args.size) if args.base else None
+    base_seq = args.base_seq if args.base_seq is not None else max(args.seq - 1, 0)
+    patches = encode(to_bytes(args.image, args.size), base, args.size, args.seq, base_seq)
+    if not patches:
+        print("no change, nothing to send")
+        return 1
+    if base is not None and patches[0][1] & FLAG_KEY:
+        print(f"delta exceeds {PAYLOAD_MAX} bytes, sending a key frame")
+    for i, p in enumerate(patches):
+        out = args.out if len(patches) == 1 else args.out.with_name(f"{args.out.stem}-{i}{args.out.suffix}")
+        out.write_bytes(p)
+        print(f"{out}: {len(p)} bytes")
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,217 @@
+#!/usr/bin/env python3
+"""Replay gateway traffic at a device and report killswitch latency.
+
+Publishes hiki/health, hiki/gateway/health and hiki/killswitch/status
+against a local broker at configurable rates, with optional bursts,
+padded, malformed and oversized payloads. Needs paho-mqtt.
+
+    ./gateway_load.py --host 192.168.1.10 --duration 120 \\
+        --health-rate 20 --gw-rate 5 --flip-every 10 --burst 50 --malformed 0.05
+
+Killswitch flips alternate between "isolated" and "armed". The device
+times each flip from receipt to framebuffer and to refresh-done and
+publishes its percentiles on <device>/telemetry/latency; this tool also
+times publish -> "flip" report as the end-to-end figure, broker hops
+included. Leave the device idle on HOME: pressing buttons mid-run mixes
+navigation refreshes into the numbers. The killswitch status is retained,
+so run this against a test broker; it is left at "armed" on exit.
+"""
+
+import argparse
+import json
+import random
+import string
+import sys
+import threading
+import time
+
+JSON_MAX = 512          # device drops gateway payloads at or above this
+
+
+def percentile(values, pct):
+    """Nearest rank, same as the device."""
+    if not values:
+        return 0
+    s = sorted(values)
+    return s[max(0, -(-pct * len(s) // 100) - 1)]
+
+
+def pad(payload: dict, size: int) -> bytes:
+    """JSON of at least `size` bytes; the device ignores unknown keys."""
+    raw = json.dumps(payload)
+    if size > len(raw):
+        payload = dict(payload, pad="x" * (size - len(raw) - 10))
+        raw = json.dumps(payload)
+    return raw.encode()
+
+
+def health(rng) -> dict:
+    return {"ha": 1, "gw": 1, "inet": 1, "ha_api": 1,
+            "ha_ms": rng.randint(5, 80), "gw_ms": rng.randint(1, 20),
+            "inet_ms": rng.randint(10, 200), "mem": rng.randint(20, 90),
+            "disk": rng.randint(10, 95), "msgs_24h": rng.randint(0, 50000),
+            "up": "3d 4h", "model": "load-sim"}
+
+
+def gw_health(rng) -> dict:
+    return {"ha_errors": rng.randint(0, 3), "ha_reachable": True}
+
+
+def malformed(rng) -> bytes:
+    kinds = [
+        b"",
+        b"{",
+        b'{"ha":',
+        b'{"state":"isol',
+        b"\xff\xfe\x00garbage",
+        b'{"state":' + b'"' * 40 + b"}",
+        "".join(rng.choice(string.printable) for _ in range(rng.randint(1, 200))).encode(),
+    ]
+    return rng.choice(kinds)
+
+
+class Sender:
+    def __init__(self, client, args):
+        self.client = client
+        self.args = args
+        self.rng = random.Random(args.seed)
+        self.sent = {"health": 0, "gw": 0, "flip": 0, "malformed": 0, "oversized": 0}
+
+    def body(self, make) -> bytes:
+        a, r = self.args, self.rng.random()
+        if r < a.malformed:
+            self.sent["malformed"] += 1
+            return malformed(self.rng)
+        if r < a.malformed + a.oversized:
+            self.sent["oversized"] += 1
+            return pad(make(self.rng), JSON_MAX + self.rng.randint(0, 3 * JSON_MAX))
+        return pad(make(self.rng), a.size)
+
+    def health(self):
+        self.client.publish("hiki/health", self.body(health), qos=self.args.qos)
+        self.sent["health"] += 1
+
+    def gw(self):
+        self.client.publish("hiki/gateway/health", self.body(gw_health), qos=self.args.qos)
+        self.sent["gw"] += 1
+
+    def flip(self, isolated: bool):
+        ks = {"state": "isolated" if isolated else "armed", "address": "4Gx" + "0" * 45,
+              "ws_connected": True, "isolated_at": time.strftime("%H:%M:%S"),
+              "block_number": 1000000 + self.sent["flip"]}
+        self.client.publish("hiki/killswitch/status", json.dumps(ks), qos=1, retain=True)
+        self.sent["flip"] += 1
+
+
+def run(args) -> int:
+    import paho.mqtt.client as mqtt
+
+    lock = threading.Lock()
+    reports = []          # device "flip" reports
+    outstanding = []      # publish times of flips not yet reported
+    e2e_ms = []
+    last = {}
+
+    def on_message(_c, _u, msg):
+        now = time.monotonic()
+        try:
+            rep = json.loads(msg.payload)
+        except ValueError:
+            return
+        with lock:
+            last.update(rep)
+            if rep.get("cause") != "flip":
+                return
+            reports.append(rep)
+            # Flips that arrived during one refresh share its report
+            if outstanding:
+                e2e_ms.append((now - outstanding[0]) * 1000)
+                outstanding.clear()
+
+    client = mqtt.Client()
+    client.on_message = on_message
+    client.connect(args.host, args.port)
+    client.subscribe(f"{args.device}/telemetry/latency")
+    client.loop_start()
+
+    sender = Sender(client, args)
+    start = time.monotonic()
+    due = {"health": start, "gw": start, "flip": start + args.flip_every, "burst": start}
+    isolated = False
+
+    while time.monotonic() - start < args.duration:
+        now = time.monotonic()
+        if args.health_rate and now >= due["health"]:
+            sender.health()
+            due["health"] += 1 / args.health_rate
+        if args.gw_rate and now >= due["gw"]:
+            sender.gw()
+            due["gw"] += 1 / args.gw_rate
+        if args.burst and now >= due["burst"]:
+            for _ in range(args.burst):
+                sender.health()
+            due["burst"] += args.burst_every
+        if args.flip_every and now >= due["flip"]:
+            isolated = not isolated
+            with lock:
+                outstanding.append(time.monotonic())
+            sender.flip(isolated)
+            due["flip"] += args.flip_every
+        next_due = min(v for k, v in due.items()
+                       if (k != "flip" or args.flip_every) and (k != "burst" or args.burst))
+        time.sleep(max(0.0, min(next_due - time.monotonic(), 0.05)))
+
+    # Let the last refresh land, then put the gateway state back
+    time.sleep(args.settle)
+    if isolated:
+        sender.flip(False)
+        time.sleep(args.settle)
+    client.loop_stop()
+
+    elapsed = time.monotonic() - start
+    print(f"sent in {elapsed:.0f}s: " + ", ".join(f"{k}={v}" for k, v in sender.sent.items()))
+    with lock:
+        if not last:
+            print(f"no report on {args.device}/telemetry/latency; is the device connected?")
+            return 1
+        print(f"device: rx={last.get('rx')} dropped={last.get('dropped')}")
+        for key in ("handle_us", "render_us", "refresh_ms"):
+            s = last.get(key, {})
+            print(f"  {key:11} n={s.get('n', 0):3} p50={s.get('p50', 0):7} "
+                  f"p90={s.get('p90', 0):7} p99={s.get('p99', 0):7} max={s.get('max', 0):7}")
+        print(f"  {'e2e_ms':11} n={len(e2e_ms):3} p50={percentile(e2e_ms, 50):7.0f} "
+              f"p90={percentile(e2e_ms, 90):7.0f} p99={percentile(e2e_ms, 99):7.0f} "
+              f"max={max(e2e_ms, default=0):7.0f}")
+        missing = sender.sent["flip"] - len(reports)
+        if missing > 0:
+            print(f"  {missing} flip(s) without a report (coalesced, or not shown)")
+    return 0
+
+
+def main() -> int:
+    ap = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    ap.add_argument("--host", default="localhost")
+    ap.add_argument("--port", type=int, default=1883)
+    ap.add_argument("--device", default="torii-ink")
+    ap.add_argument("--duration", type=float, default=60, help="seconds")
+    ap.add_argument("--health-rate", type=float, default=10, help="hiki/health msgs/s")
+    ap.add_argument("--gw-rate", type=float, default=2, help="hiki/gateway/health msgs/s")
+    ap.add_argument("--flip-every", type=float, default=10,
+                    help="seconds between killswitch flips (0: none)")
+    ap.add_argument("--burst", type=int, default=0, help="extra health msgs per burst")
+    ap.add_argument("--burst-every", type=float, default=15, help="seconds between bursts")
+    ap.add_argument("--size", type=int, default=0, help="pad payloads to this many bytes")
+    ap.add_argument("--malformed", type=float, default=0, help="fraction of garbage payloads")
+    ap.add_argument("--oversized", type=float, default=0,
+                    help=f"fraction of payloads over the device's {JSON_MAX}-byte limit")
+    ap.add_argument("--qos", type=int, default=0, choices=(0, 1))
+    ap.add_argument("--settle", type=float, default=8, help="wait for the last refresh")
+    ap.add_argument("--seed", type=int, default=1)
+    args = ap.parse_args()
+    if args.malformed + args.oversized > 1:
+        ap.error("--malformed + --oversized must not exceed 1")
+    return run(args)
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,95 @@
+#!/usr/bin/env python3
+"""Rasterize the vector icons into src/icon_sprites.h.
+
+Builds tools/icon_sprites/rasterize.cpp with the host C++ compiler against
+the firmware's own lib/epd/GUI_Paint.cpp, so the sprites are pixel-for-pixel
+what the vector helpers in tools/icon_sprites/icon_vectors.cpp draw on the
+panel. Rerun after touching either of those:
+
+    ./icon_sprites.py [--cxx g++]
+
+Output format: MSB-first, 1=WHITE 0=BLACK, rows padded to whole bytes
+(same as the framebuffer and Paint_DrawSprite).
+"""
+
+import argparse
+import os
+import subprocess
+import sys
+import tempfile
+from pathlib import Path
+
+ROOT = Path(__file__).resolve().parent.parent
+HERE = ROOT / "tools" / "icon_sprites"
+EPD = ROOT / "lib" / "epd"
+DST = ROOT / "src" / "icon_sprites.h"
+
+
+def rasterize(cxx: str) -> list:
+    with tempfile.TemporaryDirectory() as tmp:
+        exe = Path(tmp) / "rasterize"
+        subprocess.run([cxx, "-std=gnu++17", "-O1", "-w",
+                        f"-I{HERE / 'host'}", f"-I{HERE}", f"-I{EPD}", f"-I{EPD / 'fonts'}",
+                        str(HERE / "rasterize.cpp"), str(HERE / "icon_vectors.cpp"),
+                        str(EPD / "GUI_Paint.cpp"), "-o", str(exe)], check=True)
+        out = subprocess.run([str(exe)], check=True, capture_output=True, text=True).stdout
+
+    sprites = []
+    for line in out.splitlines():
+        name, dx, dy, w, h, hexbits = line.split()
+        sprites.append((name, int(dx), int(dy), int(w), int(h), bytes.fromhex(hexbits)))
+    return sprites
+
+
+def render(sprites: list) -> str:
+    lines = [
+        "#pragma once",
+        "// Auto-generated by tools/icon_sprites.py from tools/icon_sprites/icon_vectors.cpp",
+        "// Pre-rasterized icons, blitted with Paint_DrawSprite. Do not edit; change the",
+        "// vector source and regenerate.",
+        "// Format: MSB-first, 1=WHITE 0=BLACK, rows padded to whole bytes",
+        "",
+        "#include <stdint.h>",
+        "",
+        "struct Sprite {",
+        "    int8_t  dx, dy;         // top-left, relative to the vector helper's anchor",
+        "    uint8_t w, h;",
+        "    const unsigned char *bits;",
+        "};",
+        "",
+    ]
+    for name, dx, dy, w, h, bits in sprites:
+        lines.append(f"// {name.lower()}: {w}x{h}, {len(bits)} bytes")
+        lines.append(f"static const unsigned char sprite_{name.lower()}[] PROGMEM = {{")
+        for i in range(0, len(bits), 16):
+            lines.append("    " + ", ".join(f"0x{b:02X}" for b in bits[i:i + 16]) + ",")
+        lines.append("};")
+        lines.append("")
+
+    lines.append("enum SpriteId : uint8_t {")
+    for name, *_ in sprites:
+        lines.append(f"    SPRITE_{name},")
+    lines.append("    SPRITE_COUNT")
+    lines.append("};")
+    lines.append("")
+    lines.append("static const Sprite sprites[SPRITE_COUNT] = {")
+    for name, dx, dy, w, h, _ in sprites:
+        lines.append(f"    {{ {dx:3}, {dy:3}, {w:2}, {h:2}, sprite_{name.lower()} }},")
+    lines.append("};")
+    return "\n".join(lines) + "\n"
+
+
+def main() -> int:
+    ap = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    ap.add_argument("--cxx", default=os.environ.get("CXX", "c++"), help="host C++ compiler")
+    args = ap.parse_args()
+
+    sprites = rasterize(args.cxx)
+    DST.write_text(render(sprites))
+    total = sum(len(s[5]) for s in sprites)
+    print(f"{DST.relative_to(ROOT)}: {len(sprites)} sprites, {total} bytes")
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
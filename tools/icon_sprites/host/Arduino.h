@@ -0,0 +1,14 @@
+#pragma once
+// Just enough Arduino for GUI_Paint.cpp to build on the host. Only the
+// drawing code is compiled here; no GPIO/SPI symbols are needed.
+
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+struct HostSerial {
+    void print(const char *s) { fputs(s, stderr); }
+};
+static HostSerial Serial;
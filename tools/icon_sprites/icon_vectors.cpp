@@ -0,0 +1,126 @@
+// Vector icons, rasterized into src/icon_sprites.cpp by tools/icon_sprites.py.
+// Edit here, then regenerate; the firmware never calls these directly.
+
+#include "GUI_Paint.h"
+#include "icon_vectors.h"
+
+void drawIconThermo(int x, int y) {
+    Paint_DrawRectangle(x + 3, y, x + 7, y + 9, BLACK, DOT_PIXEL_1X1, DRAW_FILL_EMPTY);
+    Paint_DrawRectangle(x + 4, y + 4, x + 6, y + 9, BLACK, DOT_PIXEL_1X1, DRAW_FILL_FULL);
+    Paint_DrawCircle(x + 5, y + 13, 3, BLACK, DOT_PIXEL_1X1, DRAW_FILL_FULL);
+}
+
+void drawIconDrop(int x, int y) {
+    Paint_DrawLine(x + 5, y, x + 1, y + 8, BLACK, DOT_PIXEL_1X1, LINE_STYLE_SOLID);
+    Paint_DrawLine(x + 5, y, x + 9, y + 8, BLACK, DOT_PIXEL_1X1, LINE_STYLE_SOLID);
+    Paint_DrawCircle(x + 5, y + 10, 4, BLACK, DOT_PIXEL_1X1, DRAW_FILL_EMPTY);
+}
+
+void drawIconClock(int x, int y) {
+    int cx = x + 7, cy = y + 7;
+    Paint_DrawCircle(cx, cy, 6, BLACK, DOT_PIXEL_1X1, DRAW_FILL_EMPTY);
+    Paint_DrawLine(cx, cy, cx + 3, cy - 4, BLACK, DOT_PIXEL_1X1, LINE_STYLE_SOLID);
+    Paint_DrawLine(cx, cy, cx, cy - 5, BLACK, DOT_PIXEL_1X1, LINE_STYLE_SOLID);
+    Paint_DrawCircle(cx, cy, 1, BLACK, DOT_PIXEL_1X1, DRAW_FILL_FULL);
+}
+
+// Chip icon for AI Agent (16×16)
+void drawIconAgent(int x, int y, bool online) {
+    // Chip body
+    Paint_DrawRectangle(x+4, y+2, x+11, y+12, BLACK, DOT_PIXEL_1X1,
+                        online ? DRAW_FILL_FULL : DRAW_FILL_EMPTY);
+    // Side pins (4 pairs)
+    for (int i = 0; i < 4; i++) {
+        int py = y + 4 + i * 2;
+        Paint_DrawLine(x+2, py, x+4, py, BLACK, DOT_PIXEL_1X1, LINE_STYLE_SOLID);
+        Paint_DrawLine(x+11, py, x+13, py, BLACK, DOT_PIXEL_1X1, LINE_STYLE_SOLID);
+    }
+    // Core
+    if (online)
+        Paint_DrawRectangle(x+6, y+6, x+9, y+8, WHITE, DOT_PIXEL_1X1, DRAW_FILL_FULL);
+    else
+        Paint_DrawCircle(x+7, y+7, 1, BLACK, DOT_PIXEL_1X1, DRAW_FILL_FULL);
+}
+
+// House icon for Smart Home (16×16)
+void drawIconHome(int x, int y, bool online) {
+    int peak_x = x + 7, peak_y = y + 2;
+    int roof_l = x + 2, roof_r = x + 12, roof_base = y + 7;
+    // Roof lines
+    Paint_DrawLine(peak_x, peak_y, roof_l, roof_base, BLACK, DOT_PIXEL_1X1, LINE_STYLE_SOLID);
+    Paint_DrawLine(peak_x, peak_y, roof_r, roof_base, BLACK, DOT_PIXEL_1X1, LINE_STYLE_SOLID);
+    // Walls
+    Paint_DrawRectangle(roof_l, roof_base, roof_r, y+13, BLACK, DOT_PIXEL_1X1, DRAW_FILL_EMPTY);
+    if (online) {
+        // Fill roof
+        for (int row = peak_y + 1; row < roof_base; row++) {
+            int half_w = row - peak_y;
+            Paint_DrawLine(peak_x - half_w, row, peak_x + half_w, row,
+                           BLACK, DOT_PIXEL_1X1, LINE_STYLE_SOLID);
+        }
+        // Fill walls
+        Paint_DrawRectangle(roof_l, roof_base, roof_r, y+13, BLACK, DOT_PIXEL_1X1, DRAW_FILL_FULL);
+        // Door cutout
+        Paint_DrawRectangle(x+5, y+10, x+8, y+13, WHITE, DOT_PIXEL_1X1, DRAW_FILL_FULL);
+    } else {
+        // Door outline
+        Paint_DrawRectangle(x+5, y+10, x+7, y+13, BLACK, DOT_PIXEL_1X1, DRAW_FILL_EMPTY);
+    }
+}
+
+// Router icon for Gateway (16×16)
+void drawIconGateway(int x, int y, bool online) {
+    // Device body
+    Paint_DrawRectangle(x+2, y+6, x+13, y+12, BLACK, DOT_PIXEL_1X1,
+                        online ? DRAW_FILL_FULL : DRAW_FILL_EMPTY);
+    // Antennas
+    Paint_DrawLine(x+6, y+6, x+2, y+1, BLACK, DOT_PIXEL_1X1, LINE_STYLE_SOLID);
+    Paint_DrawLine(x+9, y+6, x+13, y+1, BLACK, DOT_PIXEL_1X1, LINE_STYLE_SOLID);
+    // LED indicators
+    UWORD led_color = online ? WHITE : BLACK;
+    Paint_SetPixel(x+5, y+9, led_color);
+    Paint_SetPixel(x+8, y+9, led_color);
+    Paint_SetPixel(x+11, y+9, led_color);
+}
+
+// 0..4 filled bars (16×15)
+void drawSignalBars(int x, int y, int bars) {
+    for (int i = 0; i < 4; i++) {
+        int bx = x + i * 5;
+        int bh = 4 + i * 3;
+        int by = y + 14 - bh;
+        Paint_DrawRectangle(bx, by, bx + 3, y + 14, BLACK, DOT_PIXEL_1X1,
+                            (i < bars) ? DRAW_FILL_FULL : DRAW_FILL_EMPTY);
+    }
+}
+
+// Shield icon
+void drawShield(int cx, int cy, int s, bool filled) {
+    int w = s * 3 / 4;
+    int top = cy - s, mid = cy + s / 3, bot = cy + s;
+    Paint_DrawLine(cx - w, top, cx + w, top, BLACK, DOT_PIXEL_2X2, LINE_STYLE_SOLID);
+    Paint_DrawLine(cx - w, top, cx - w, mid, BLACK, DOT_PIXEL_2X2, LINE_STYLE_SOLID);
+    Paint_DrawLine(cx + w, top, cx + w, mid, BLACK, DOT_PIXEL_2X2, LINE_STYLE_SOLID);
+    Paint_DrawLine(cx - w, mid, cx, bot, BLACK, DOT_PIXEL_2X2, LINE_STYLE_SOLID);
+    Paint_DrawLine(cx + w, mid, cx, bot, BLACK, DOT_PIXEL_2X2, LINE_STYLE_SOLID);
+    if (filled) {
+        for (int y = top + 2; y < mid; y++)
+            Paint_DrawLine(cx - w + 2, y, cx + w - 2, y, BLACK, DOT_PIXEL_1X1, LINE_STYLE_SOLID);
+        for (int y = mid; y < bot; y++) {
+            int narrow = w * (y - mid) / (bot - mid);
+            int lx = cx - w + narrow + 2, rx = cx + w - narrow - 2;
+            if (lx < rx) Paint_DrawLine(lx, y, rx, y, BLACK, DOT_PIXEL_1X1, LINE_STYLE_SOLID);
+        }
+    }
+}
+
+// Warning triangle with exclamation mark
+void drawWarning(int cx, int top_y, int h) {
+    int w = h * 2 / 3;
+    int bot = top_y + h;
+    Paint_DrawLine(cx, top_y, cx - w, bot, BLACK, DOT_PIXEL_2X2, LINE_STYLE_SOLID);
+    Paint_DrawLine(cx, top_y, cx + w, bot, BLACK, DOT_PIXEL_2X2, LINE_STYLE_SOLID);
+    Paint_DrawLine(cx - w, bot, cx + w, bot, BLACK, DOT_PIXEL_2X2, LINE_STYLE_SOLID);
+    Paint_DrawLine(cx, top_y + h / 3, cx, bot - h / 3, BLACK, DOT_PIXEL_2X2, LINE_STYLE_SOLID);
+    Paint_DrawCircle(cx, bot - 4, 2, BLACK, DOT_PIXEL_1X1, DRAW_FILL_FULL);
+}
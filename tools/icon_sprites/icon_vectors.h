@@ -0,0 +1,14 @@
+#pragma once
+// Vector icon helpers: the source of truth for src/icon_sprites.cpp.
+// Only built on the host by tools/icon_sprites.py; the firmware blits the
+// rasterized result instead of calling these.
+
+void drawIconThermo(int x, int y);
+void drawIconDrop(int x, int y);
+void drawIconClock(int x, int y);
+void drawIconAgent(int x, int y, bool online);
+void drawIconHome(int x, int y, bool online);
+void drawIconGateway(int x, int y, bool online);
+void drawSignalBars(int x, int y, int bars);
+void drawShield(int cx, int cy, int s, bool filled);
+void drawWarning(int cx, int top_y, int h);
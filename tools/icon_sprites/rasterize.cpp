@@ -0,0 +1,87 @@
+// Host harness for tools/icon_sprites.py: draws every icon variant with the
+// firmware's own GUI_Paint on a scratch canvas and prints the tight bounding
+// box of its black pixels, one sprite per line:
+//
+//     NAME dx dy w h HEX
+//
+// dx/dy place the box relative to the point the vector helper was called
+// with (2X2 strokes reach above/left of it); HEX is MSB-first 1bpp rows
+// padded to whole bytes, 1 = white, like the framebuffer.
+
+#include <stdio.h>
+
+#include "GUI_Paint.h"
+#include "icon_vectors.h"
+
+#define CANVAS 96
+#define ANCHOR 32
+
+static UBYTE canvas[CANVAS / 8 * CANVAS];
+
+struct Variant {
+    const char *name;
+    void (*draw)(int x, int y);
+};
+
+static const Variant variants[] = {
+    { "THERMO",       [](int x, int y) { drawIconThermo(x, y); } },
+    { "DROP",         [](int x, int y) { drawIconDrop(x, y); } },
+    { "CLOCK",        [](int x, int y) { drawIconClock(x, y); } },
+    { "AGENT_ON",     [](int x, int y) { drawIconAgent(x, y, true); } },
+    { "AGENT_OFF",    [](int x, int y) { drawIconAgent(x, y, false); } },
+    { "HOME_ON",      [](int x, int y) { drawIconHome(x, y, true); } },
+    { "HOME_OFF",     [](int x, int y) { drawIconHome(x, y, false); } },
+    { "GATEWAY_ON",   [](int x, int y) { drawIconGateway(x, y, true); } },
+    { "GATEWAY_OFF",  [](int x, int y) { drawIconGateway(x, y, false); } },
+    { "BARS_0",       [](int x, int y) { drawSignalBars(x, y, 0); } },
+    { "BARS_1",       [](int x, int y) { drawSignalBars(x, y, 1); } },
+    { "BARS_2",       [](int x, int y) { drawSignalBars(x, y, 2); } },
+    { "BARS_3",       [](int x, int y) { drawSignalBars(x, y, 3); } },
+    { "BARS_4",       [](int x, int y) { drawSignalBars(x, y, 4); } },
+    // Centre-anchored; sizes are the ones the screens use
+    { "SHIELD",       [](int x, int y) { drawShield(x, y, 16, true); } },
+    { "SHIELD_EMPTY", [](int x, int y) { drawShield(x, y, 16, false); } },
+    { "WARNING",      [](int x, int y) { drawWarning(x, y, 30); } },
+};
+
+static bool black(int x, int y) {
+    return !(canvas[y * (CANVAS / 8) + x / 8] & (0x80 >> (x % 8)));
+}
+
+int main() {
+    Paint_NewImage(canvas, CANVAS, CANVAS, ROTATE_0, WHITE);
+    for (const Variant &v : variants) {
+        Paint_Clear(WHITE);
+        v.draw(ANCHOR, ANCHOR);
+
+        int x0 = CANVAS, y0 = CANVAS, x1 = -1, y1 = -1;
+        for (int y = 0; y < CANVAS; y++)
+            for (int x = 0; x < CANVAS; x++)
+                if (black(x, y)) {
+                    if (x < x0) x0 = x;
+                    if (x > x1) x1 = x;
+                    if (y < y0) y0 = y;
+                    if (y > y1) y1 = y;
+                }
+        if (x1 < 0) {
+            fprintf(stderr, "%s: nothing drawn\n", v.name);
+            return 1;
+        }
+        if (x0 == 0 || y0 == 0 || x1 == CANVAS - 1 || y1 == CANVAS - 1) {
+            fprintf(stderr, "%s: touches the canvas edge, raise CANVAS\n", v.name);
+            return 1;
+        }
+
+        int w = x1 - x0 + 1, h = y1 - y0 + 1;
+        printf("%s %d %d %d %d ", v.name, x0 - ANCHOR, y0 - ANCHOR, w, h);
+        for (int y = y0; y <= y1; y++)
+            for (int bx = 0; bx < (w + 7) / 8; bx++) {
+                UBYTE byte = 0xFF;
+                for (int b = 0; b < 8 && bx * 8 + b < w; b++)
+                    if (black(x0 + bx * 8 + b, y)) byte &= ~(0x80 >> b);
+                printf("%02X", byte);
+            }
+        printf("\n");
+    }
+    return 0;
+}
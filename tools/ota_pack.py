@@ -0,0 +1,240 @@
+#!/usr/bin/env python3
+"""Compress a firmware image for <device>/ota and optionally push it.
+
+The output is a heatshrink stream (window 10, lookahead 5) that the device
+decompresses on the fly; `heatshrink -e -w 10 -l 5` produces the same
+format. Serve it over HTTP and publish the printed request:
+
+    ./ota_pack.py .pio/build/esp32c6/firmware.bin -o fw.hs
+    python3 -m http.server -d . 8000
+    mosquitto_pub -t torii-ink/ota -m '<printed json with url>'
+
+Or push it in MQTT chunks (needs paho-mqtt):
+
+    ./ota_pack.py firmware.bin -o fw.hs --push --host 192.168.1.10
+
+Firmware built with OTA_SIGN_KEY refuses requests without a signature;
+add --sign-key ota_key.pem (the private key, needs `cryptography`). Builds
+without it accept OTA only when MQTT runs over TLS.
+
+Progress and errors arrive on <device>/ota/status.
+"""
+
+import argparse
+import hashlib
+import json
+import struct
+import sys
+import threading
+from pathlib import Path
+
+WINDOW_BITS = 10
+LOOKAHEAD_BITS = 5
+MAX_OFFSET = 1 << WINDOW_BITS
+MAX_COUNT = 1 << LOOKAHEAD_BITS
+MIN_MATCH = 2           # 1+W+L = 16 bits beats two 9-bit literals
+CHAIN_LIMIT = 32
+CHUNK = 3072            # stays inside the device's 4 KiB MQTT buffer
+
+
+class BitWriter:
+    def __init__(self):
+        self.out = bytearray()
+        self.acc = 0
+        self.bits = 0
+
+    def put(self, value: int, n: int):
+        self.acc = (self.acc << n) | value
+        self.bits += n
+        while self.bits >= 8:
+            self.bits -= 8
+            self.out.append((self.acc >> self.bits) & 0xFF)
+        self.acc &= (1 << self.bits) - 1
+
+    def finish(self) -> bytes:
+        if self.bits:
+            self.out.append((self.acc << (8 - self.bits)) & 0xFF)
+            self.bits = self.acc = 0
+        return bytes(self.out)
+
+
+def compress(data: bytes) -> bytes:
+    """Greedy LZSS with hash chains over 3-byte prefixes."""
+    w = BitWriter()
+    head = {}
+    prev = [0] * len(data)
+    n = len(data)
+    i = 0
+
+    def insert(pos):
+        if pos + 3 <= n:
+            key = data[pos:pos + 3]
+            prev[pos] = head.get(key, -1)
+            head[key] = pos
+
+    while i < n:
+        best_len, best_off = 0, 0
+        if i + MIN_MATCH <= n:
+            limit = min(MAX_COUNT, n - i)
+            cand = head.get(data[i:i + 3], -1) if i + 3 <= n else -1
+            chain = 0
+            while cand >= 0 and i - cand <= MAX_OFFSET and chain < CHAIN_LIMIT:
+                length = 0
+                while length < limit and data[cand + length] == data[i + length]:
+                    length += 1
+                if length > best_len:
+                    best_len, best_off = length, i - cand
+                    if length == limit:
+                        break
+                cand = prev[cand]
+                chain += 1
+            # Two-byte repeats are too short to hash; try the previous byte
+            if best_len < MIN_MATCH and i >= 1 and data[i - 1] == data[i] \
+                    and i + 1 < n and data[i] == data[i + 1]:
+                length = 0
+                while length < limit and data[i - 1 + length] == data[i + length]:
+                    length += 1
+                best_len, best_off = length, 1
+
+        if best_len >= MIN_MATCH:
+            w.put(0, 1)
+            w.put(best_off - 1, WINDOW_BITS)
+            w.put(best_len - 1, LOOKAHEAD_BITS)
+            for k in range(best_len):
+                insert(i + k)
+            i += best_len
+        else:
+            w.put(1, 1)
+            w.put(data[i], 8)
+            insert(i)
+            i += 1
+    return w.finish()
+
+
+def decompress(blob: bytes, size: int) -> bytes:
+    """Reference decoder, mirrors src/heatshrink_stream.cpp."""
+    out = bytearray()
+    acc, bits, pos = 0, 0, 0
+
+    def take(n):
+        nonlocal acc, bits, pos
+        while bits < n:
+            if pos >= len(blob):
+                return None
+            acc = (acc << 8) | blob[pos]
+            pos += 1
+            bits += 8
+        bits -= n
+        return (acc >> bits) & ((1 << n) - 1)
+
+    while len(out) < size:
+        tag = take(1)
+        if tag is None:
+            break
+        if tag:
+            out.append(take(8))
+        else:
+            off = take(WINDOW_BITS) + 1
+            cnt = take(LOOKAHEAD_BITS) + 1
+            for _ in range(cnt):
+                out.append(out[-off] if off <= len(out) else 0)
+    return bytes(out)
+
+
+def sign(key_path: Path, image: bytes) -> str:
+    """DER ECDSA P-256 signature over the image, as the device's "sig"."""
+    from cryptography.hazmat.primitives import hashes, serialization
+    from cryptography.hazmat.primitives.asymmetric import ec
+
+    key = serialization.load_pem_private_key(key_path.read_bytes(), password=None)
+    if not isinstance(key, ec.EllipticCurvePrivateKey) or key.curve.name != "secp256r1":
+        sys.exit(f"{key_path}: not an ECDSA P-256 private key")
+    return key.sign(image, ec.ECDSA(hashes.SHA256())).hex()
+
+
+def push(args, device: str, blob: bytes, request: dict):
+    import paho.mqtt.client as mqtt
+
+    have = threading.Condition()
+    state = {"have": -1, "state": "", "error": "", "acks": 0}
+
+    def on_message(_c, _u, msg):
+        st = json.loads(msg.payload)
+        with have:
+            state.update(have=st.get("have", -1), state=st.get("state", ""),
+                         error=st.get("error", ""), acks=state["acks"] + 1)
+            have.notify()
+
+    client = mqtt.Client()
+    client.on_message = on_message
+    client.connect(args.host, args.port)
+    client.subscribe(f"{device}/ota/status")
+    client.loop_start()
+
+    def wait(pred, what):
+        with have:
+            if not have.wait_for(pred, timeout=args.timeout):
+                sys.exit(f"timeout waiting for {what}")
+        if state["state"] == "failed":
+            sys.exit(f"device: {state['error']}")
+
+    client.publish(f"{device}/ota", json.dumps(request), qos=1)
+    wait(lambda: state["state"] in ("receiving", "failed"), "start")
+
+    offset = 0
+    while offset < len(blob):
+        chunk = blob[offset:offset + CHUNK]
+        acks = state["acks"]
+        client.publish(f"{device}/ota/chunk", struct.pack("<I", offset) + chunk, qos=1)
+        wait(lambda: state["acks"] > acks, f"ack @{offset}")
+        if state["state"] != "receiving":
+            break
+        offset = state["have"]   # resume point, also after a refused chunk
+        print(f"\r{offset}/{len(blob)}", end="", flush=True)
+    print()
+    wait(lambda: state["state"] in ("done", "failed"), "verify")
+    print("device verified image, rebooting")
+    client.loop_stop()
+
+
+def main() -> int:
+    ap = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    ap.add_argument("firmware", type=Path)
+    ap.add_argument("-o", "--out", type=Path, required=True)
+    ap.add_argument("--url-base", default="http://<host>:8000/",
+                    help="prefix for the url printed in the request")
+    ap.add_argument("--raw", action="store_true", help="skip compression")
+    ap.add_argument("--sign-key", type=Path,
+                    help="PEM private key matching the firmware's OTA_SIGN_KEY")
+    ap.add_argument("--device", default="torii-ink")
+    ap.add_argument("--push", action="store_true", help="send as MQTT chunks")
+    ap.add_argument("--host", default="localhost")
+    ap.add_argument("--port", type=int, default=1883)
+    ap.add_argument("--timeout", type=float, default=30)
+    args = ap.parse_args()
+
+    image = args.firmware.read_bytes()
+    blob = image if args.raw else compress(image)
+    if not args.raw and decompress(blob, len(image)) != image:
+        print("internal error: round-trip mismatch", file=sys.stderr)
+        return 1
+    args.out.write_bytes(blob)
+
+    request = {
+        "sha256": hashlib.sha256(image).hexdigest(),
+        "size": len(image),
+        "encoding": "raw" if args.raw else "hs",
+    }
+    if args.sign_key:
+        request["sig"] = sign(args.sign_key, image)
+    print(f"{args.out}: {len(image)} -> {len(blob)} bytes "
+          f"({100 * len(blob) / max(len(image), 1):.0f}%)")
+    if args.push:
+        push(args, args.device, blob, dict(request, length=len(blob)))
+    else:
+        print(json.dumps(dict(request, url=args.url_base + args.out.name)))
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())